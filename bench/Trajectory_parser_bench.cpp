@@ -0,0 +1,153 @@
+// Local
+#include "src/Trajectory_parser.h"
+// std
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifndef MANYLANDS_BENCH_INPUT
+#define MANYLANDS_BENCH_INPUT "assets/model1-default.txt"
+#endif
+
+namespace
+{
+const size_t Default_num_tiles = 1000;
+const int    Num_runs = 5;
+
+//******************************************************************************
+// read_lines
+//******************************************************************************
+
+bool read_lines(const std::string& fname, std::vector<std::string>& lines)
+{
+    std::ifstream stream(fname, std::ios::binary);
+    if(!stream.is_open())
+        return false;
+
+    std::string line;
+    while(std::getline(stream, line))
+    {
+        if(!line.empty())
+            lines.push_back(line);
+    }
+
+    return lines.size() > 1;
+}
+
+//******************************************************************************
+// write_tiled
+//
+// Writes the lines of the source trajectory `num_tiles` times. The time in the
+// first column is shifted by the duration of the source in every copy, so the
+// time keeps increasing as in a long run of the solver. The other columns are
+// copied as they are
+//******************************************************************************
+
+bool write_tiled(
+    const std::vector<std::string>& lines,
+    size_t num_tiles,
+    const std::string& fname)
+{
+    std::ofstream stream(fname, std::ios::binary | std::ios::trunc);
+    if(!stream.is_open())
+        return false;
+
+    std::vector<double> times(lines.size());
+    std::vector<size_t> rest(lines.size());
+    for(size_t i = 0; i < lines.size(); ++i)
+    {
+        char* end;
+        times[i] = std::strtod(lines[i].c_str(), &end);
+        rest[i] = end - lines[i].c_str();
+    }
+    // The step between the copies is the one between the first two points
+    const double duration = times.back() - times.front() + times[1] - times[0];
+
+    char time[64];
+    for(size_t tile = 0; tile < num_tiles; ++tile)
+    {
+        for(size_t i = 0; i < lines.size(); ++i)
+        {
+            const int size = std::snprintf(
+                time, sizeof(time), "%.18e", times[i] + tile * duration);
+            stream.write(time, size);
+            stream.write(
+                lines[i].data() + rest[i], lines[i].size() - rest[i]);
+            stream.put('\n');
+        }
+    }
+
+    return stream.good();
+}
+} // namespace
+
+//******************************************************************************
+// main
+//
+// Times Trajectory_parser::parse_file on the output of a solver tiled into a
+// large file and prints the best of several runs. The arguments are the source
+// file (assets/model1-default.txt by default) and the number of the copies
+//******************************************************************************
+
+int main(int argc, char* argv[])
+{
+    const std::string source = argc > 1 ? argv[1] : MANYLANDS_BENCH_INPUT;
+    const size_t num_tiles = argc > 2 ?
+        static_cast<size_t>(std::strtoull(argv[2], nullptr, 10)) :
+        Default_num_tiles;
+
+    std::vector<std::string> lines;
+    if(!read_lines(source, lines))
+    {
+        std::printf("Cannot read %s\n", source.c_str());
+        return 1;
+    }
+
+    const auto fname =
+        (std::filesystem::temp_directory_path() / "manylands_bench.txt")
+            .string();
+    if(!write_tiled(lines, num_tiles, fname))
+    {
+        std::printf("Cannot write %s\n", fname.c_str());
+        return 1;
+    }
+    const auto file_size = std::filesystem::file_size(fname);
+
+    double best_time = 0.;
+    size_t num_parsed = 0;
+    for(int run = 0; run < Num_runs; ++run)
+    {
+        Trajectory_data data;
+        const auto start = std::chrono::steady_clock::now();
+        if(!Trajectory_parser::parse_file(fname, data))
+        {
+            std::printf("Cannot parse %s\n", fname.c_str());
+            std::filesystem::remove(fname);
+            return 1;
+        }
+        const double time = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+
+        best_time = run == 0 ? time : std::min(best_time, time);
+        num_parsed = data.size();
+    }
+    std::filesystem::remove(fname);
+
+    std::printf(
+        "%s x %zu: %zu points, %.1f MB, best of %d runs: %.3f s\n",
+        source.c_str(),
+        num_tiles,
+        num_parsed,
+        file_size / 1e6,
+        Num_runs,
+        best_time);
+    std::printf("%.1f MB/s\n", file_size / 1e6 / best_time);
+    std::printf("%.2f M points/s\n", num_parsed / 1e6 / best_time);
+
+    return num_parsed == lines.size() * num_tiles ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+#include "Alloc_counter.h"
+// std
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef COUNT_ALLOCATIONS
+namespace
+{
+std::atomic<size_t> Count(0);
+
+//******************************************************************************
+// counted_alloc
+//******************************************************************************
+
+void* counted_alloc(std::size_t size)
+{
+    Count.fetch_add(1, std::memory_order_relaxed);
+
+    void* ptr = std::malloc(size > 0 ? size : 1);
+    if(ptr == nullptr)
+        throw std::bad_alloc();
+
+    return ptr;
+}
+} // namespace
+#endif // COUNT_ALLOCATIONS
+
+//******************************************************************************
+// get_count
+//******************************************************************************
+
+size_t Alloc_counter::get_count()
+{
+#ifdef COUNT_ALLOCATIONS
+    return Count.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif // COUNT_ALLOCATIONS
+}
+
+#ifdef COUNT_ALLOCATIONS
+
+// The replacements of the global allocation functions. The nothrow and the
+// aligned versions of the standard library are not replaced, the first ones
+// call these, the second ones are used only for the curve point columns
+
+void* operator new(std::size_t size)
+{
+    return counted_alloc(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return counted_alloc(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+#endif // COUNT_ALLOCATIONS
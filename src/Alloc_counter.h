@@ -0,0 +1,12 @@
+#pragma once
+// std
+#include <cstddef>
+
+// Counts the calls of the global operator new, the number of allocations made
+// by a frame is the difference of the counts taken before and after it. The
+// operator is replaced only if COUNT_ALLOCATIONS is defined (see the
+// MANYLANDS_COUNT_ALLOCATIONS option), otherwise the count stays 0
+namespace Alloc_counter
+{
+size_t get_count();
+} // namespace Alloc_counter
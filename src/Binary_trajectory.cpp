@@ -0,0 +1,303 @@
+#include "Binary_trajectory.h"
+// Local
+#include "Mapped_file.h"
+#include "Thread_pool.h"
+// std
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+
+namespace
+{
+// Location of the values in a mapped file
+struct Layout
+{
+    size_t data_offset = 0;
+    size_t num_rows = 0;
+    size_t num_columns = 0;
+    size_t value_size = 0; // 4 for float32, 8 for float64
+};
+
+//******************************************************************************
+// is_little_endian
+//******************************************************************************
+
+bool is_little_endian()
+{
+    const uint16_t probe = 1;
+    uint8_t first_byte;
+    std::memcpy(&first_byte, &probe, 1);
+    return first_byte == 1;
+}
+
+//******************************************************************************
+// find_value
+//
+// Returns the position of the value of the key in the header of a .npy file,
+// which is a Python dictionary literal, e.g. "{'descr': '<f8', ...}"
+//******************************************************************************
+
+const char* find_value(const std::string& header, const char* key)
+{
+    auto pos = header.find(key);
+    if(pos == std::string::npos)
+        return nullptr;
+
+    pos = header.find(':', pos);
+    if(pos == std::string::npos)
+        return nullptr;
+
+    ++pos;
+    while(pos < header.size() && header[pos] == ' ')
+        ++pos;
+
+    return header.c_str() + pos;
+}
+
+//******************************************************************************
+// read_npy_layout
+//******************************************************************************
+
+bool read_npy_layout(const char* data, size_t size, Layout& layout)
+{
+    const char magic[6] = {'\x93', 'N', 'U', 'M', 'P', 'Y'};
+    if(size < 10 || std::memcmp(data, magic, sizeof(magic)) != 0)
+        return false;
+
+    // Version 1 has a 16-bit header length, versions 2 and 3 have 32-bit one
+    const uint8_t major_version = static_cast<uint8_t>(data[6]);
+    size_t header_begin, header_len;
+    if(major_version == 1)
+    {
+        header_begin = 10;
+        header_len = static_cast<uint8_t>(data[8]) |
+                     static_cast<uint8_t>(data[9]) << 8;
+    }
+    else if(major_version == 2 || major_version == 3)
+    {
+        if(size < 12)
+            return false;
+        header_begin = 12;
+        header_len = 0;
+        for(size_t i = 0; i < 4; ++i)
+        {
+            header_len |=
+                size_t(static_cast<uint8_t>(data[8 + i])) << (8 * i);
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    if(header_begin + header_len > size)
+        return false;
+    const std::string header(data + header_begin, header_len);
+
+    auto descr = find_value(header, "'descr'");
+    if(descr == nullptr)
+        return false;
+    if(std::strncmp(descr, "'<f4'", 5) == 0)
+        layout.value_size = 4;
+    else if(std::strncmp(descr, "'<f8'", 5) == 0)
+        layout.value_size = 8;
+    else
+        return false;
+
+    auto fortran_order = find_value(header, "'fortran_order'");
+    if(fortran_order == nullptr ||
+       std::strncmp(fortran_order, "False", 5) != 0)
+    {
+        return false;
+    }
+
+    // Only two-dimensional arrays are supported, e.g. "(1000, 5)"
+    auto shape = find_value(header, "'shape'");
+    if(shape == nullptr || *shape != '(')
+        return false;
+    const char* shape_end = header.c_str() + header.size();
+
+    size_t dims[2];
+    const char* p = shape + 1;
+    for(size_t i = 0; i < 2; ++i)
+    {
+        while(p < shape_end && (*p == ' ' || *p == ','))
+            ++p;
+        auto res = std::from_chars(p, shape_end, dims[i]);
+        if(res.ec != std::errc())
+            return false;
+        p = res.ptr;
+    }
+    while(p < shape_end && (*p == ' ' || *p == ','))
+        ++p;
+    if(p == shape_end || *p != ')')
+        return false;
+
+    layout.data_offset = header_begin + header_len;
+    layout.num_rows = dims[0];
+    layout.num_columns = dims[1];
+
+    return layout.num_columns > 0 &&
+           layout.data_offset +
+               layout.num_rows * layout.num_columns * layout.value_size <=
+           size;
+}
+
+//******************************************************************************
+// read_raw_layout
+//******************************************************************************
+
+bool read_raw_layout(const std::string& fname, size_t size, Layout& layout)
+{
+    const std::filesystem::path path(fname);
+    layout.value_size = path.extension() == ".f32" ? 4 : 8;
+
+    // The number of the columns can be given before the extension
+    layout.num_columns = 5;
+    const std::string columns = path.stem().extension().string();
+    if(columns.size() > 1)
+    {
+        size_t num_columns = 0;
+        auto res = std::from_chars(
+            columns.data() + 1,
+            columns.data() + columns.size(),
+            num_columns);
+        if(res.ec == std::errc() &&
+           res.ptr == columns.data() + columns.size() &&
+           num_columns > 0)
+        {
+            layout.num_columns = num_columns;
+        }
+    }
+
+    // An incomplete last row, e.g. one being written, is ignored
+    layout.data_offset = 0;
+    layout.num_rows =
+        size / (layout.num_columns * layout.value_size);
+
+    return true;
+}
+
+//******************************************************************************
+// convert
+//******************************************************************************
+
+template<typename T>
+void convert(
+    const char* data,
+    const Layout& layout,
+    const Trajectory_parser::Columns& columns,
+    size_t num_samples,
+    Trajectory_data& out)
+{
+    const size_t num_rows = num_samples == 0 ? layout.num_rows : num_samples;
+    for(size_t i = 0; i < columns.size(); ++i)
+    {
+        if(columns[i] != Trajectory_parser::No_column)
+            out.column(i).resize(num_rows);
+    }
+
+    // Rows are converted in blocks on the thread pool
+    const size_t block_size = 1 << 16;
+    const size_t num_blocks = (num_rows + block_size - 1) / block_size;
+
+    Thread_pool::global().parallel_for(num_blocks, [&](size_t b) {
+        const size_t first = b * block_size;
+        const size_t last = std::min(first + block_size, num_rows);
+
+        for(size_t i = 0; i < columns.size(); ++i)
+        {
+            if(columns[i] == Trajectory_parser::No_column)
+                continue;
+
+            auto& column = out.column(i);
+            for(size_t r = first; r < last; ++r)
+            {
+                const size_t row = num_samples == 0 ?
+                    r :
+                    r * layout.num_rows / num_samples;
+
+                // The values are copied as they might be not aligned
+                T value;
+                std::memcpy(
+                    &value,
+                    data + (row * layout.num_columns + columns[i]) * sizeof(T),
+                    sizeof(T));
+                column[r] = static_cast<float>(value);
+            }
+        }
+    });
+}
+} // namespace
+
+//******************************************************************************
+// is_binary
+//******************************************************************************
+
+bool Binary_trajectory::is_binary(const std::string& fname)
+{
+    const auto extension = std::filesystem::path(fname).extension();
+    return extension == ".npy" || extension == ".f32" || extension == ".f64";
+}
+
+//******************************************************************************
+// load
+//******************************************************************************
+
+bool Binary_trajectory::load(
+    const std::string& fname,
+    Trajectory_data& out,
+    const Trajectory_parser::Columns& columns/* = Default_columns*/,
+    size_t num_samples/* = 0*/)
+{
+    Mapped_file file(fname);
+    if(!file.is_open())
+        return false;
+
+    return load(fname, file.data(), file.size(), out, columns, num_samples);
+}
+
+//******************************************************************************
+// load
+//******************************************************************************
+
+bool Binary_trajectory::load(
+    const std::string& fname,
+    const char* data,
+    size_t size,
+    Trajectory_data& out,
+    const Trajectory_parser::Columns& columns/* = Default_columns*/,
+    size_t num_samples/* = 0*/)
+{
+    if(!is_little_endian())
+        return false;
+
+    Layout layout;
+    const bool is_npy = std::filesystem::path(fname).extension() == ".npy";
+    if(!(is_npy ? read_npy_layout(data, size, layout) :
+                  read_raw_layout(fname, size, layout)))
+    {
+        return false;
+    }
+
+    if(!Trajectory_parser::is_complete(columns))
+        return false;
+    for(auto c : columns)
+    {
+        if(c >= layout.num_columns)
+            return false;
+    }
+
+    if(num_samples >= layout.num_rows)
+        num_samples = 0;
+
+    const char* values = data + layout.data_offset;
+    if(layout.value_size == 4)
+        convert<float>(values, layout, columns, num_samples, out);
+    else
+        convert<double>(values, layout, columns, num_samples, out);
+
+    return true;
+}
@@ -0,0 +1,46 @@
+#pragma once
+// Local
+#include "Trajectory_data.h"
+#include "Trajectory_parser.h"
+// std
+#include <string>
+
+// Loader of binary trajectory files. The files are memory-mapped and the
+// loaded columns are converted to float without any text parsing. Every row of
+// a file is a point of a trajectory and the columns are selected the same way
+// as for the text files (see Trajectory_parser::Columns). Supported formats:
+//
+// - NumPy ".npy": a two-dimensional C-order array of little-endian float32
+//   ("<f4") or float64 ("<f8") values with the shape (points, columns).
+//
+// - Raw ".f32" / ".f64": little-endian float32 / float64 values stored row by
+//   row without any header. A row has five values (t, x, y, z, w) unless the
+//   number of the columns is given in the file name before the extension,
+//   e.g. "lorenz.12.f64" has twelve values in every row.
+namespace Binary_trajectory
+{
+// Returns true if the file name has an extension of a binary format
+bool is_binary(const std::string& fname);
+
+// Maps the file and reads the columns. If `num_samples` is not zero, only the
+// given number of rows evenly spread over the file are read. Returns false if
+// the file cannot be read or does not have the columns
+bool load(
+    const std::string& fname,
+    Trajectory_data& out,
+    const Trajectory_parser::Columns& columns =
+        Trajectory_parser::Default_columns,
+    size_t num_samples = 0);
+
+// Reads the columns from the content of a file that is already in memory. The
+// name of the file selects the format the same way as is_binary() does
+bool load(
+    const std::string& fname,
+    const char* data,
+    size_t size,
+    Trajectory_data& out,
+    const Trajectory_parser::Columns& columns =
+        Trajectory_parser::Default_columns,
+    size_t num_samples = 0);
+
+} // namespace Binary_trajectory
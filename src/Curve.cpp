@@ -1,79 +1,344 @@
 #include "Curve.h"
-
-#include "Scene_wireframe_object.h"
-
+// local
+#include "Thread_pool.h"
 // std
 #include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <list>
+#include <vector>
 // boost
 #include <boost/numeric/ublas/assignment.hpp>
-// VVV needed for boost::geometry::simplify VVV
-#include <boost/geometry.hpp>
-#include <boost/geometry/geometries/linestring.hpp>
-#include <boost/geometry/geometries/point.hpp>
 
-const Color Curve::default_color_ = Color(0, 0, 0, 255);
+namespace
+{
+// Queue of a bounded size in a ring buffer. The sliding windows of a curve
+// push and pop every point once, a std::deque would allocate its blocks
+// over and over
+template<class T>
+class Ring_queue
+{
+public:
+    // The capacity is rounded up to a power of two
+    explicit Ring_queue(size_t capacity)
+        : items_(round_up(capacity)),
+          mask_(items_.size() - 1),
+          first_(0),
+          last_(0)
+    {
+    }
+
+    bool empty() const { return first_ == last_; }
+    T&   front()       { return items_[first_ & mask_]; }
+    T&   back()        { return items_[(last_ - 1) & mask_]; }
+
+    void push_back(const T& item) { items_[last_++ & mask_] = item; }
+    void pop_front()              { ++first_; }
+    void pop_back()               { --last_; }
+
+private:
+    static size_t round_up(size_t capacity)
+    {
+        size_t n = 1;
+        while(n < capacity)
+            n *= 2;
+        return n;
+    }
+
+    std::vector<T> items_;
+    size_t mask_;
+    size_t first_, last_; // Counters of the pushed and popped items
+};
+
+// Number of windows between the checks of the cancellation
+const size_t Cancel_check_interval = 65536;
+
+//******************************************************************************
+// find_window_end
+//
+// Moves the end of the time window of the point i forward to the first point
+// that is more than the kernel size later. Returns false if there is no such
+// point, the window is open
+//******************************************************************************
+
+bool find_window_end(
+    Span<const float> time_stamp,
+    float kernel_size,
+    size_t i,
+    size_t& end)
+{
+    end = std::max(end, i);
+    while(end < time_stamp.size() &&
+          !(time_stamp[end] - time_stamp[i] > kernel_size))
+    {
+        ++end;
+    }
+    return end < time_stamp.size();
+}
+} // namespace
+
+//******************************************************************************
+// get_points
+//******************************************************************************
+
+Point_store& Curve::get_points()
+{
+    dequantize();
+    return points_;
+}
+
+//******************************************************************************
+// points
+//******************************************************************************
+
+const Point_store& Curve::points(Point_store& buffer) const
+{
+    if(!is_quantized())
+        return points_;
+
+    quantized_.decode(buffer);
+    return buffer;
+}
+
+//******************************************************************************
+// decode_points
+//******************************************************************************
+
+void Curve::decode_points(Point_store& out) const
+{
+    if(is_quantized())
+        quantized_.decode(out);
+    else
+        out = points_;
+}
+
+//******************************************************************************
+// size
+//******************************************************************************
+
+size_t Curve::size() const
+{
+    return is_quantized() ? quantized_.size() : points_.size();
+}
+
+//******************************************************************************
+// num_segments
+//******************************************************************************
+
+size_t Curve::num_segments() const
+{
+    return size() == 0 ? 0 : size() - 1;
+}
+
+//******************************************************************************
+// quantize
+//******************************************************************************
+
+void Curve::quantize()
+{
+    if(is_quantized())
+        return;
+
+    quantized_.encode(points_);
+    points_ = Point_store();
+}
+
+//******************************************************************************
+// dequantize
+//******************************************************************************
+
+void Curve::dequantize()
+{
+    if(!is_quantized())
+        return;
+
+    quantized_.decode(points_);
+    quantized_.clear();
+}
+
+//******************************************************************************
+// is_quantized
+//******************************************************************************
+
+bool Curve::is_quantized() const
+{
+    return !quantized_.empty();
+}
+
+//******************************************************************************
+// memory_size
+//******************************************************************************
+
+size_t Curve::memory_size() const
+{
+    return points_.memory_size() + quantized_.memory_size();
+}
 
 //******************************************************************************
 // add_point
 //******************************************************************************
 
-void Curve::add_point(Scene_vertex_t vertex, float time)
+void Curve::add_point(const Scene_vertex_t& vertex, float time)
+{
+    dequantize();
+    points_.push_back(time, vertex);
+}
+
+//******************************************************************************
+// add_points
+//
+// Both are stored by columns, the columns are copied as a whole
+//******************************************************************************
+
+void Curve::add_points(const Trajectory_data& data)
 {
-    // Adding vertex
-    get_vertices().push_back(vertex);
+    dequantize();
+    const size_t first = points_.size();
+    points_.resize(first + data.size());
 
-    // Adding edge
-    if(get_vertices().size() > 1)
-        add_edge(Scene_wireframe_edge(get_vertices().size() - 2,
-                                      get_vertices().size() - 1,
-                                      default_color_));
+    std::copy(
+        data.time.begin(), data.time.end(), points_.time().begin() + first);
+    for(size_t k = 0; k < 4; ++k)
+    {
+        std::copy(
+            data.coords[k].begin(),
+            data.coords[k].end(),
+            points_.coord(k).begin() + first);
+    }
+    std::fill(points_.coord(4).begin() + first, points_.coord(4).end(), 1.f);
+}
 
-    // Adding time stamp
-    time_stamp_.push_back(time);
+//******************************************************************************
+// get_point
+//
+// A quantized curve is decoded for the call, the callers with many points use
+// the overload with a view
+//******************************************************************************
+
+Scene_vertex_t Curve::get_point(float time) const
+{
+    Point_store buffer;
+    return get_point(time, points(buffer));
 }
 
 //******************************************************************************
 // get_point
+//
+// Interpolates the point in a view of the curve, the view has to have the
+// time stamps of the curve
 //******************************************************************************
 
-Scene_vertex_t Curve::get_point(float time)
+Scene_vertex_t Curve::get_point(float time, const Point_store& view) const
 {
+    Scene_vertex_t point(Point_store::Num_coords);
+    get_point(time, view, point);
+    return point;
+}
+
+//******************************************************************************
+// get_point
+//******************************************************************************
+
+void Curve::get_point(
+    float time,
+    const Point_store& view,
+    Scene_vertex_t& out) const
+{
+    const auto time_stamp = view.time();
+    out.resize(Point_store::Num_coords, false);
+
+    auto copy_vertex = [&view, &out](size_t i) {
+        for(size_t k = 0; k < Point_store::Num_coords; ++k)
+            out(k) = view.coord(k)[i];
+    };
+
     // We assume that points are already sorted by the time stamp value
-    if(time <= time_stamp_.front())
-        return get_vertices().front();
+    if(time <= time_stamp.front())
+    {
+        copy_vertex(0);
+        return;
+    }
 
-    if(time >= time_stamp_.back())
-        return get_vertices().back();
+    if(time >= time_stamp.back())
+    {
+        copy_vertex(view.size() - 1);
+        return;
+    }
 
     size_t range[2];
     range[0] = 0;
-    range[1] = time_stamp_.size() - 1;
+    range[1] = time_stamp.size() - 1;
 
     while(range[1] - range[0] > 1)
     {
         size_t middle = static_cast<size_t>(0.5f * (range[1] + range[0]));
-        if(time_stamp_[middle] > time)
+        if(time_stamp[middle] > time)
             range[1] = middle;
         else
             range[0] = middle;
     }
 
-    float coeff = (time - time_stamp_[range[0]]) /
-                  (time_stamp_[range[1]] - time_stamp_[range[0]]);
+    float coeff = (time - time_stamp[range[0]]) /
+                  (time_stamp[range[1]] - time_stamp[range[0]]);
+
+    for(size_t k = 0; k < Point_store::Num_coords; ++k)
+    {
+        const auto c = view.coord(k);
+        out(k) = c[range[0]] + coeff * (c[range[1]] - c[range[0]]);
+    }
+}
+
+//******************************************************************************
+// translate_vertices
+//******************************************************************************
+
+void Curve::translate_vertices(boost::numeric::ublas::vector<double> translate)
+{
+    dequantize();
+    points_.translate(translate);
+}
+
+//******************************************************************************
+// scale_vertices
+//******************************************************************************
+
+void Curve::scale_vertices(double scale_factor)
+{
+    dequantize();
+    points_.scale(scale_factor);
+}
+
+//******************************************************************************
+// scale_vertices
+//******************************************************************************
+
+void Curve::scale_vertices(boost::numeric::ublas::vector<double> scale_factor)
+{
+    assert(scale_factor.size() == Point_store::Num_coords);
+    dequantize();
+    points_.scale(scale_factor);
+}
+
+//******************************************************************************
+// get_boundaries
+//******************************************************************************
 
-    return get_vertices()[range[0]] +
-           coeff * (get_vertices()[range[1]] - get_vertices()[range[0]]);
+void Curve::get_boundaries(Scene_vertex_t& origin, Scene_vertex_t& size) const
+{
+    if(is_quantized())
+        quantized_.get_boundaries(origin, size);
+    else
+        points_.get_boundaries(origin, size);
 }
 
 //******************************************************************************
-// time_stamp
+// time_at
 //******************************************************************************
 
-const std::vector<float>& Curve::time_stamp() const
+float Curve::time_at(size_t i) const
 {
-    return time_stamp_;
+    return is_quantized() ? quantized_.time(i) : points_.time()[i];
 }
 
 //******************************************************************************
@@ -82,7 +347,7 @@ const std::vector<float>& Curve::time_stamp() const
 
 float Curve::t_min() const
 {
-    return time_stamp_.front();
+    return time_at(0);
 }
 
 //******************************************************************************
@@ -91,7 +356,7 @@ float Curve::t_min() const
 
 float Curve::t_max() const
 {
-    return time_stamp_.back();
+    return time_at(size() - 1);
 }
 
 //******************************************************************************
@@ -109,40 +374,52 @@ float Curve::t_duration() const
 // Provides a simplified curve using the RamerDouglasPeucker algorithm
 //******************************************************************************
 
-Curve Curve::get_simpified_curve(const float max_deviation)
+Curve Curve::get_simpified_curve(const float max_deviation) const
 {
-    typedef boost::geometry::model::
-        point<float, 4, boost::geometry::cs::cartesian>
-            pt4d_t;
-    typedef boost::geometry::model::linestring<pt4d_t> linestring4d_t;
-    linestring4d_t line;
+    Point_store buffer;
+    return get_simpified_curve(
+        Point_ranking(points(buffer)), max_deviation);
+}
 
-    auto to_boost = [](const Scene_vertex_t& v) -> pt4d_t {
-        pt4d_t out;
-        out.set<0>(v(0));
-        out.set<1>(v(1));
-        out.set<2>(v(2));
-        out.set<3>(v(3));
-        return out;
-    };
-    for(auto v : vertices_)
-        boost::geometry::append(line, to_boost(v));
+//******************************************************************************
+// get_simpified_curve
+//
+// Takes the points kept by the ranking, the points are copied by their
+// indices. Like boost::geometry::simplify, two equal points are reduced to
+// one
+//******************************************************************************
 
-    linestring4d_t simplified;
-    boost::geometry::simplify(line, simplified, max_deviation);
+Curve Curve::get_simpified_curve(
+    const Point_ranking& ranking,
+    float max_deviation) const
+{
+    Point_store buffer;
+    const auto& points = this->points(buffer);
+    assert(ranking.size() <= points.size());
+
+    std::vector<uint32_t> indices;
+    ranking.get_indices(max_deviation, indices);
+    // The points added after the ranking are not simplified
+    for(size_t i = ranking.size(); i < points.size(); ++i)
+        indices.push_back(static_cast<uint32_t>(i));
+
+    const auto time_stamp = points.time();
+    const auto x = points.coord(0), y = points.coord(1),
+               z = points.coord(2), w = points.coord(3),
+               h = points.coord(4);
+    if(indices.size() == 2 &&
+       x[indices[0]] == x[indices[1]] && y[indices[0]] == y[indices[1]] &&
+       z[indices[0]] == z[indices[1]] && w[indices[0]] == w[indices[1]])
+    {
+        indices.pop_back();
+    }
 
     Curve simple_curve;
-    size_t i = 0;
-    auto is_equal = [](const pt4d_t& p,
-                       const Scene_vertex_t& v) -> bool {
-        return p.get<0>() == v(0) && p.get<1>() == v(1) && p.get<2>() == v(2) &&
-               p.get<3>() == v(3);
-    };
-    for(const auto& p4d : simplified)
+    simple_curve.points_.reserve(indices.size());
+    for(const auto i : indices)
     {
-        while(!is_equal(p4d, vertices()[i]))
-            ++i;
-        simple_curve.add_point(vertices()[i], time_stamp()[i]);
+        simple_curve.points_.push_back(
+            time_stamp[i], x[i], y[i], z[i], w[i], h[i]);
     }
     return simple_curve;
 }
@@ -153,187 +430,469 @@ Curve Curve::get_simpified_curve(const float max_deviation)
 
 void Curve::update_stats(float kernel_size, float max_movement, float max_value)
 {
-    calculate_general_stats(kernel_size, max_movement, max_value);
-    calculate_annotations();
+    // The statistics are computed on the float columns, a quantized curve
+    // decodes them only for the time of the computation
+    const bool quantized = is_quantized();
+    if(quantized)
+        quantized_.decode(points_);
+
+    Window_extrema extrema;
+    calculate_window_extrema(points_, 0, kernel_size, extrema, nullptr);
+    calculate_stats(
+        points_, extrema, max_movement, max_value, stats_, nullptr);
+
+    if(quantized)
+        points_ = Point_store();
+}
+
+//******************************************************************************
+// update_stats_tail
+//
+// Updates statistics after points were appended to the curve. Only the part of
+// the curve affected by the new points is recomputed. The thresholds depend on
+// the curve boundaries, so if the new points extend the boundaries, the
+// statistics are recomputed for the whole curve
+//******************************************************************************
+
+void Curve::update_stats_tail(size_t first_new_point)
+{
+    const size_t old_size = stats_.stats.dimensionality.size();
+    if(old_size == 0 || old_size != first_new_point ||
+       first_new_point > points_.size())
+    {
+        update_stats(
+            stats_.kernel_size, stats_.max_movement, stats_.max_value);
+        return;
+    }
+
+    for(int k = 0; k < 4; ++k)
+    {
+        const auto c = points_.coord(k);
+        for(size_t i = first_new_point; i < c.size(); ++i)
+        {
+            if(c[i] < stats_.origin(k) ||
+               c[i] > stats_.origin(k) + stats_.size(k))
+            {
+                update_stats(
+                    stats_.kernel_size, stats_.max_movement, stats_.max_value);
+                return;
+            }
+        }
+    }
+
+    stats_.stats.dimensionality.resize(
+        points_.size(), Curve_stats::All_dims);
+
+    // Dimensionality may change only for points covered by the open windows
+    const size_t first_changed = stats_.first_open_window;
+
+    Window_extrema extrema;
+    calculate_window_extrema(
+        points_, first_changed, stats_.kernel_size, extrema, nullptr);
+
+    calculate_speed(points_, first_new_point - 1, stats_);
+    calculate_dimensionality(points_, extrema, stats_);
+    calculate_switches(points_, first_changed, stats_);
+    calculate_annotations(points_, stats_);
 }
 
 //******************************************************************************
 // get_stats
 //******************************************************************************
 
-const Curve_stats& Curve::get_stats()
+const Curve_stats& Curve::get_stats() const
 {
-    return stats_;
+    return stats_.stats;
 }
 
 //******************************************************************************
-// calculate_general_stats
+// calculate_window_extrema
 //******************************************************************************
 
-void Curve::calculate_general_stats(
+bool Curve::calculate_window_extrema(
     float kernel_size,
+    Window_extrema& out,
+    const std::atomic<bool>* is_canceled) const
+{
+    Point_store buffer;
+    return calculate_window_extrema(
+        points(buffer), 0, kernel_size, out, is_canceled);
+}
+
+//******************************************************************************
+// calculate_stats
+//******************************************************************************
+
+bool Curve::calculate_stats(
+    const Window_extrema& extrema,
+    float max_movement,
+    float max_value,
+    Stats_data& out,
+    const std::atomic<bool>* is_canceled) const
+{
+    Point_store buffer;
+    return calculate_stats(
+        points(buffer), extrema, max_movement, max_value, out, is_canceled);
+}
+
+//******************************************************************************
+// set_stats
+//******************************************************************************
+
+void Curve::set_stats(Stats_data&& data)
+{
+    assert(data.stats.dimensionality.size() == size());
+    stats_ = std::move(data);
+}
+
+//******************************************************************************
+// calculate_window_extrema
+//
+// Processes the time windows starting from the given point. The window of a
+// point ends at the first point that is more than the kernel size later, a
+// window without such a point (at the end of the curve) is left open and is
+// processed again when new points are added.
+//
+// The time stamps are sorted, so both ends of the windows move forward: the
+// extrema of a window are kept in monotonic queues, one pass per coordinate
+//******************************************************************************
+
+bool Curve::calculate_window_extrema(
+    const Point_store& points,
+    size_t first_window,
+    float kernel_size,
+    Window_extrema& out,
+    const std::atomic<bool>* is_canceled) const
+{
+    const auto time_stamp = points.time();
+    const size_t num_points = time_stamp.size();
+
+    // The windows starting from the first open one are all open. The queues
+    // below hold at most the points of the longest window
+    size_t first_open = first_window, max_window_size = 0;
+    for(size_t end = first_window;
+        first_open < num_points &&
+        find_window_end(time_stamp, kernel_size, first_open, end);
+        ++first_open)
+    {
+        max_window_size = std::max(max_window_size, end - first_open + 1);
+    }
+
+    out.kernel_size = kernel_size;
+    out.first_window = first_window;
+    out.first_open_window = std::min(first_open, num_points);
+    out.max_window_size = max_window_size;
+
+    const size_t num_windows =
+        first_open > first_window ? first_open - first_window : 0;
+    Thread_pool::global().parallel_for(4, [&](size_t k) {
+        const auto c = points.coord(k);
+        auto& movement = out.movement[k];
+        auto& max = out.max[k];
+        movement.resize(num_windows);
+        max.resize(num_windows);
+
+        // Indices of the points in the window with increasing values for the
+        // minimum and decreasing ones for the maximum
+        Ring_queue<size_t> min_q(max_window_size + 2);
+        Ring_queue<size_t> max_q(max_window_size + 2);
+        size_t end = first_window, next_point = first_window;
+        for(size_t i = first_window; i < first_open; ++i)
+        {
+            if(i % Cancel_check_interval == 0 && is_canceled && *is_canceled)
+                return;
+
+            find_window_end(time_stamp, kernel_size, i, end);
+            for(; next_point <= end; ++next_point)
+            {
+                const float v = c[next_point];
+                while(!min_q.empty() && c[min_q.back()] >= v)
+                    min_q.pop_back();
+                min_q.push_back(next_point);
+                while(!max_q.empty() && c[max_q.back()] <= v)
+                    max_q.pop_back();
+                max_q.push_back(next_point);
+            }
+            while(min_q.front() < i)
+                min_q.pop_front();
+            while(max_q.front() < i)
+                max_q.pop_front();
+
+            movement[i - first_window] = c[max_q.front()] - c[min_q.front()];
+            max[i - first_window] = c[max_q.front()];
+        }
+    });
+
+    return !(is_canceled && *is_canceled);
+}
+
+//******************************************************************************
+// calculate_stats
+//******************************************************************************
+
+bool Curve::calculate_stats(
+    const Point_store& points,
+    const Window_extrema& extrema,
     float max_movement,
-    float max_value)
+    float max_value,
+    Stats_data& data,
+    const std::atomic<bool>* is_canceled) const
 {
-    stats_ = Curve_stats();
+    data = Stats_data();
+
+    // Remember the parameters, they are needed to update the statistics when
+    // new points are added
+    data.kernel_size = extrema.kernel_size;
+    data.max_movement = max_movement;
+    data.max_value = max_value;
+    get_boundaries(data.origin, data.size);
 
     // Fill with default values
-    // out_stats.dimensionality.clear();
-    stats_.dimensionality.resize(vertices_.size());
-    for(auto& d : stats_.dimensionality)
-        d = "xyzw";
+    auto& stats = data.stats;
+    stats.dimensionality.assign(points.size(), Curve_stats::All_dims);
 
-    auto min_speed = std::numeric_limits<float>::max();
-    auto max_speed = std::numeric_limits<float>::min();
+    stats.min_speed = std::numeric_limits<float>::max();
+    stats.max_speed = std::numeric_limits<float>::min();
+
+    calculate_speed(points, 0, data);
+    calculate_dimensionality(points, extrema, data);
+    if(is_canceled && *is_canceled)
+        return false;
+
+    calculate_switches(points, 0, data);
+    calculate_annotations(points, data);
+
+    return !(is_canceled && *is_canceled);
+}
 
-    // Calculate speed
-    for(const auto& e : edges_)
+//******************************************************************************
+// calculate_speed
+//
+// Calculates speed for segments starting from the given one. The squared
+// lengths are accumulated column by column
+//******************************************************************************
+
+void Curve::calculate_speed(
+    const Point_store& points,
+    size_t first_segment,
+    Stats_data& data) const
+{
+    auto& stats = data.stats;
+    auto& speed = stats.speed;
+    const size_t first = std::min(first_segment, speed.size());
+    const size_t last = points.empty() ? 0 : points.size() - 1;
+    speed.resize(last);
+    if(first >= last)
+        return;
+
+    std::fill(speed.begin() + first, speed.end(), 0.f);
+    for(int j = 0; j < 4; ++j)
     {
-        auto diff = vertices_[e.vert1] - vertices_[e.vert2];
+        const float* c = points.coord(j).data();
+        for(size_t i = first; i < last; ++i)
+        {
+            const float diff = c[i] - c[i + 1];
+            speed[i] += diff * diff;
+        }
+    }
 
-        auto s = 0.f;
-        for(int j = 0; j < 4; ++j)
-            s += diff(j) * diff(j);
-        s = std::sqrt(s) /
-            std::abs(time_stamp_[e.vert2] - time_stamp_[e.vert1]);
+    const float* t = points.time().data();
+    for(size_t i = first; i < last; ++i)
+    {
+        const float s = std::sqrt(speed[i]) / std::abs(t[i + 1] - t[i]);
 
-        min_speed = std::min(s, min_speed);
-        max_speed = std::max(s, max_speed);
+        stats.min_speed = std::min(s, stats.min_speed);
+        stats.max_speed = std::max(s, stats.max_speed);
 
-        stats_.speed.push_back(s);
+        speed[i] = s;
     }
+}
 
-    // Assign max and min speed to the statistic instance
-    stats_.min_speed = min_speed;
-    stats_.max_speed = max_speed;
+//******************************************************************************
+// calculate_dimensionality
+//
+// A point gets the lowest dimensionality among all closed windows that
+// contain it, the earliest window wins among the equal ones. The windows
+// containing a point are kept in a queue ordered by their dimensionality, so
+// the assignment is a single sweep
+//******************************************************************************
 
-    Scene_vertex_t origin, size;
-    get_boundaries(origin, size);
-    auto abs_max_movement = max_movement * size;
-    auto abs_max_value = origin + max_value * size;
+void Curve::calculate_dimensionality(
+    const Point_store& points,
+    const Window_extrema& extrema,
+    Stats_data& data) const
+{
+    auto abs_max_movement = data.max_movement * data.size;
+    auto abs_max_value = data.origin + data.max_value * data.size;
+
+    const auto time_stamp = points.time();
+    const size_t num_points = time_stamp.size();
+    const size_t first_window = extrema.first_window;
+    const size_t first_open = extrema.first_open_window;
+    data.first_open_window = first_open;
 
-    // Find how many dimension curve segments have
-    Scene_vertex_t min(5), max(5);
-    float start_t = 0.f, end_t = 0.f;
-    for(size_t i = 0; i < time_stamp_.size(); ++i)
+    struct Window
+    {
+        size_t end;
+        Curve_stats::Dim_mask dim;
+        int num_dims;
+    };
+    // Windows containing the current point, the first one has the lowest
+    // dimensionality
+    Ring_queue<Window> windows(extrema.max_window_size + 2);
+    size_t next_window = first_window, end = first_window;
+    for(size_t p = first_window; p < num_points; ++p)
     {
-        start_t = time_stamp_[i];
-        min = max = vertices_[i];
-        for(size_t j = i; j < time_stamp_.size(); ++j)
+        for(; next_window <= p && next_window < first_open; ++next_window)
         {
-            end_t = time_stamp_[j];
-            // Update min and max
-            for(int k = 0; k < 5; ++k)
+            const size_t e = next_window - first_window;
+            Window w;
+            find_window_end(
+                time_stamp, extrema.kernel_size, next_window, end);
+            w.end = end;
+            w.dim = 0;
+            for(int k = 0; k < 4; ++k)
             {
-                min(k) = std::min(min(k), vertices_[j](k));
-                max(k) = std::max(max(k), vertices_[j](k));
-            }
-
-            if(end_t - start_t > kernel_size)
-            {
-                bool activeness[4];
-                for(int k = 0; k < 4; ++k)
-                    activeness[k] = (max(k) - min(k)) > abs_max_movement(k) ||
-                                    max(k) > abs_max_value(k);
-
-                std::string dim = "";
-                dim += activeness[0] ? "x" : "";
-                dim += activeness[1] ? "y" : "";
-                dim += activeness[2] ? "z" : "";
-                dim += activeness[3] ? "w" : "";
-
-                for(size_t k = i; k <= j; ++k)
+                if(extrema.movement[k][e] > abs_max_movement(k) ||
+                   extrema.max[k][e] > abs_max_value(k))
                 {
-                    if(dim.length() < stats_.dimensionality[k].length())
-                    {
-                        stats_.dimensionality[k] = dim;
-                    }
+                    w.dim |= 1 << k;
                 }
+            }
+            w.num_dims = Curve_stats::num_dims(w.dim);
 
+            while(!windows.empty() && windows.back().num_dims > w.num_dims)
+                windows.pop_back();
+            windows.push_back(w);
+        }
+        while(!windows.empty() && windows.front().end < p)
+            windows.pop_front();
+        if(windows.empty())
+        {
+            if(next_window == first_open)
                 break;
-            }
+            continue;
         }
+
+        auto& d = data.stats.dimensionality[p];
+        if(windows.front().num_dims < Curve_stats::num_dims(d))
+            d = windows.front().dim;
     }
+}
+
+//******************************************************************************
+// calculate_switches
+//
+// Finds switches and ranges of the segments between them. Switches before the
+// given point are kept
+//******************************************************************************
+
+void Curve::calculate_switches(
+    const Point_store& points,
+    size_t first_point,
+    Stats_data& data) const
+{
+    auto& stats = data.stats;
+    auto& switches = stats.switches_inds;
+    while(!switches.empty() && switches.back() >= first_point)
+        switches.pop_back();
+
+    // Ranges of the segments that end before the first kept switch are valid
+    const size_t num_kept = switches.size();
 
-    for(size_t i = 1; i < stats_.dimensionality.size(); ++i)
+    for(size_t i = std::max(first_point, size_t(1));
+        i < stats.dimensionality.size();
+        ++i)
     {
-        if(stats_.dimensionality[i - 1] != stats_.dimensionality[i])
+        if(stats.dimensionality[i - 1] != stats.dimensionality[i])
         {
-            stats_.switches_inds.push_back(i);
+            switches.push_back(i);
         }
     }
 
-    auto compute_range = [this](size_t ind1, size_t ind2) {
+    const auto x = points.coord(0), y = points.coord(1),
+               z = points.coord(2), w = points.coord(3);
+    auto compute_range = [&](size_t ind1, size_t ind2) {
         Curve_stats::Range r;
         for(size_t i = ind1; i < ind2; ++i)
         {
-            std::get<0>(r.x) = std::min(std::get<0>(r.x), vertices_[i](0));
-            std::get<1>(r.x) = std::max(std::get<0>(r.x), vertices_[i](0));
+            std::get<0>(r.x) = std::min(std::get<0>(r.x), x[i]);
+            std::get<1>(r.x) = std::max(std::get<0>(r.x), x[i]);
 
-            std::get<0>(r.y) = std::min(std::get<0>(r.y), vertices_[i](1));
-            std::get<1>(r.y) = std::max(std::get<0>(r.y), vertices_[i](1));
+            std::get<0>(r.y) = std::min(std::get<0>(r.y), y[i]);
+            std::get<1>(r.y) = std::max(std::get<0>(r.y), y[i]);
 
-            std::get<0>(r.z) = std::min(std::get<0>(r.z), vertices_[i](2));
-            std::get<1>(r.z) = std::max(std::get<0>(r.z), vertices_[i](2));
+            std::get<0>(r.z) = std::min(std::get<0>(r.z), z[i]);
+            std::get<1>(r.z) = std::max(std::get<0>(r.z), z[i]);
 
-            std::get<0>(r.w) = std::min(std::get<0>(r.w), vertices_[i](3));
-            std::get<1>(r.w) = std::max(std::get<0>(r.w), vertices_[i](3));
+            std::get<0>(r.w) = std::min(std::get<0>(r.w), w[i]);
+            std::get<1>(r.w) = std::max(std::get<0>(r.w), w[i]);
         }
-        stats_.range.push_back(r);
+        stats.range.push_back(r);
     };
 
-    if(stats_.switches_inds.size() > 0)
-        compute_range(0, stats_.switches_inds.front());
+    // A curve without switches has no ranges
+    stats.range.resize(switches.empty() ? 0 : num_kept);
+    if(switches.empty())
+        return;
 
-    for(size_t i = 1; i < stats_.switches_inds.size(); ++i)
-        compute_range(stats_.switches_inds[i - 1], stats_.switches_inds[i]);
-
-    if(stats_.switches_inds.size() > 0)
-        compute_range(stats_.switches_inds.back(), vertices_.size());
+    for(size_t i = num_kept; i <= switches.size(); ++i)
+    {
+        size_t start = i == 0 ? 0 : switches[i - 1];
+        size_t end = i < switches.size() ? switches[i] : points.size();
+        compute_range(start, end);
+    }
 }
 
 //******************************************************************************
 // calculate_annotations
 //******************************************************************************
 
-void Curve::calculate_annotations()
+void Curve::calculate_annotations(
+    const Point_store& points,
+    Stats_data& data) const
 {
-    arrows_.clear();
-    markers_.clear();
-
-    auto make_center_point = [&](size_t start, size_t end, std::string dim) {
+    const auto& stats = data.stats;
+    auto& arrows = data.arrows;
+    auto& markers = data.markers;
+    arrows.clear();
+    markers.clear();
+
+    auto make_center_point = [&](size_t start,
+                                 size_t end,
+                                 Curve_stats::Dim_mask dim) {
         const float epsilon = 0.2f;
 
         Scene_vertex_t center_pnt(5);
         center_pnt <<= 0, 0, 0, 0, 0;
 
-        auto start_t = time_stamp_[start];
-        auto end_t = time_stamp_[end];
+        auto start_t = points.time()[start];
+        auto end_t = points.time()[end];
 
         auto avrg_t = 0.5f * (start_t + end_t);
 
-        Scene_vertex_t current_point = get_point(avrg_t);
-        Scene_vertex_t dir = get_point(avrg_t + epsilon);
+        Scene_vertex_t current_point = get_point(avrg_t, points);
+        Scene_vertex_t dir = get_point(avrg_t + epsilon, points);
 
-        Arrow_type a(avrg_t, static_cast<int>(dim.length()));
-        arrows_.push_back(a);
+        Arrow_type a(avrg_t, Curve_stats::num_dims(dim));
+        arrows.push_back(a);
     };
 
     size_t start_ind = 0, end_ind = 0;
-    for(size_t i = 1; i < stats_.dimensionality.size(); ++i)
+    for(size_t i = 1; i < stats.dimensionality.size(); ++i)
     {
-        if(stats_.dimensionality[start_ind] == stats_.dimensionality[i])
+        if(stats.dimensionality[start_ind] == stats.dimensionality[i])
         {
             end_ind = i;
         }
         else
         {
-            make_center_point(start_ind, end_ind, stats_.dimensionality[i - 1]);
-            markers_.push_back(i);
+            make_center_point(start_ind, end_ind, stats.dimensionality[i - 1]);
+            markers.push_back(i);
             start_ind = i;
         }
     }
-    make_center_point(start_ind, end_ind, stats_.dimensionality[start_ind]);
+    make_center_point(start_ind, end_ind, stats.dimensionality[start_ind]);
 
     // Filter annotation points
     /*const double min_dist = 20;
@@ -367,26 +926,44 @@ void Curve::calculate_annotations()
 //******************************************************************************
 
 std::vector<Curve_annotations>
-Curve::get_arrows(const Curve_selection& selection)
+Curve::get_arrows(const Curve_selection& selection) const
 {
+    Point_store buffer;
     std::vector<Curve_annotations> annotations;
+    get_arrows(selection, points(buffer), annotations);
+    return annotations;
+}
 
-    for(auto& a : arrows_)
+//******************************************************************************
+// get_arrows
+//
+// The elements of `out` are overwritten, so their vertices are not allocated
+// again
+//******************************************************************************
+
+void Curve::get_arrows(
+    const Curve_selection& selection,
+    const Point_store& view,
+    std::vector<Curve_annotations>& out) const
+{
+    size_t n = 0;
+    for(auto& a : stats_.arrows)
     {
         float t = a.get<0>();
 
         if(!selection.in_range(t))
             continue;
 
-        Curve_annotations annotation;
-        annotation.point = get_point(t);
-        annotation.dir = get_point(t + 0.01f);
-        annotation.dimensionality = a.get<1>();
+        if(n == out.size())
+            out.emplace_back();
 
-        annotations.push_back(annotation);
+        auto& annotation = out[n++];
+        get_point(t, view, annotation.point);
+        get_point(t + 0.01f, view, annotation.dir);
+        annotation.dimensionality = a.get<1>();
     }
 
-    return annotations;
+    out.resize(n);
 }
 
 //******************************************************************************
@@ -394,15 +971,37 @@ Curve::get_arrows(const Curve_selection& selection)
 //******************************************************************************
 
 std::vector<Scene_vertex_t>
-Curve::get_markers(const Curve_selection& selection)
+Curve::get_markers(const Curve_selection& selection) const
 {
-    std::vector<Scene_vertex_t> res;
+    Point_store buffer;
+    std::vector<Scene_vertex_t> markers;
+    get_markers(selection, points(buffer), markers);
+    return markers;
+}
 
-    for(auto& m : markers_)
+//******************************************************************************
+// get_markers
+//******************************************************************************
+
+void Curve::get_markers(
+    const Curve_selection& selection,
+    const Point_store& view,
+    std::vector<Scene_vertex_t>& out) const
+{
+    size_t n = 0;
+    for(auto& m : stats_.markers)
     {
-        if(selection.in_range(time_stamp_[m]))
-            res.push_back(vertices_[m]);
+        if(!selection.in_range(view.time()[m]))
+            continue;
+
+        if(n == out.size())
+            out.emplace_back(Point_store::Num_coords);
+
+        auto& marker = out[n++];
+        marker.resize(Point_store::Num_coords, false);
+        for(size_t k = 0; k < Point_store::Num_coords; ++k)
+            marker(k) = view.coord(k)[m];
     }
 
-    return res;
+    out.resize(n);
 }
@@ -4,51 +4,173 @@
 #include "Curve_selection.h"
 #include "Curve_stats.h"
 #include "Color.h"
-#include "Scene_wireframe_object.h"
+#include "Point_ranking.h"
+#include "Point_store.h"
+#include "Quantized_store.h"
+#include "Span.h"
+#include "Trajectory_data.h"
 // boost
 #include "boost/tuple/tuple.hpp"
 #include <boost/numeric/ublas/vector.hpp>
 // std
+#include <atomic>
 #include <vector>
 
-class Curve : public Scene_wireframe_object
+// The points of the curve are kept column by column in a Point_store, or
+// in a Quantized_store after quantize(). The curve is a polyline, so the
+// edges are not stored: segment i connects the points i and i + 1
+class Curve
 {
 public:
     typedef boost::tuple<float, int> Arrow_type;
 
-    void add_point(Scene_vertex_t vertex, float time);
-    Scene_vertex_t get_point(float time);
+    // Statistics with the parameters they are computed for. They are replaced
+    // as a whole, so statistics computed in the background never show up
+    // partially
+    struct Stats_data
+    {
+        Curve_stats stats;
+        std::vector<Arrow_type> arrows;
+        std::vector<size_t>     markers;
+
+        float kernel_size = 0.f,
+              max_movement = 0.f,
+              max_value = 0.f;
+        Scene_vertex_t origin, size;
+        // The first time window that was shorter than the kernel size
+        size_t first_open_window = 0;
+    };
+
+    // Movement and maximum of the coordinates in the closed time windows of
+    // the switch detection, entry i belongs to the window of the point
+    // first_window + i. They do not depend on the thresholds
+    struct Window_extrema
+    {
+        float  kernel_size = 0.f;
+        size_t first_window = 0;
+        size_t first_open_window = 0;
+        size_t max_window_size = 0; // In points
+        std::vector<float> movement[4], max[4];
+    };
+
+    Point_store& get_points();
+    // The points of a quantized curve are decoded into the buffer, which is
+    // returned, the points of a float curve are returned directly
+    const Point_store& points(Point_store& buffer) const;
+    // Copies or decodes the points
+    void decode_points(Point_store& out) const;
+
+    size_t size() const;
+    size_t num_segments() const;
+
+    // A quantized curve keeps its points in a Quantized_store. Changing the
+    // points of a quantized curve brings back the float columns
+    void quantize();
+    void dequantize();
+    bool is_quantized() const;
+
+    size_t memory_size() const;
+
+    void add_point(const Scene_vertex_t& vertex, float time);
+    void add_points(const Trajectory_data& data);
+    Scene_vertex_t get_point(float time) const;
+    // The same for a view of the curve: a transformed copy of its points
+    Scene_vertex_t get_point(float time, const Point_store& view) const;
+    // The same into a vertex, which is not reallocated if it has the size of
+    // a point already
+    void get_point(
+        float time,
+        const Point_store& view,
+        Scene_vertex_t& out) const;
+
+    void translate_vertices(boost::numeric::ublas::vector<double> translate);
+    void scale_vertices(double scale_factor);
+    void scale_vertices(boost::numeric::ublas::vector<double> scale_factor);
+    void get_boundaries(Scene_vertex_t& origin, Scene_vertex_t& size) const;
 
     // Timestamp-related functions
-    const std::vector<float>& time_stamp() const;
+    float time_at(size_t i) const;
     float t_min() const;
     float t_max() const;
     float t_duration() const;
 
-    Curve get_simpified_curve(const float max_deviation);
+    Curve get_simpified_curve(const float max_deviation) const;
+    // The same with the ranking of the points of this curve, see
+    // Point_ranking. Points added after the ranking are all kept
+    Curve get_simpified_curve(
+        const Point_ranking& ranking,
+        float max_deviation) const;
 
     void update_stats(
         float kernel_size,
         float max_movement,
         float max_value);
-    const Curve_stats& get_stats();
-
-    std::vector<Curve_annotations> get_arrows(const Curve_selection& selection);
-    std::vector<Scene_vertex_t> get_markers(const Curve_selection& selection);
+    void update_stats_tail(size_t first_new_point);
+    const Curve_stats& get_stats() const;
 
-private:
-    void calculate_general_stats(
+    // update_stats() in steps that do not change the curve, e.g. for a
+    // preview computed in the background. The window extrema are reused as
+    // long as the kernel size and the points stay the same. Return false if
+    // they are canceled, the output is incomplete then
+    bool calculate_window_extrema(
         float kernel_size,
+        Window_extrema& out,
+        const std::atomic<bool>* is_canceled = nullptr) const;
+    bool calculate_stats(
+        const Window_extrema& extrema,
         float max_movement,
-        float max_value);
-    void calculate_annotations();
+        float max_value,
+        Stats_data& out,
+        const std::atomic<bool>* is_canceled = nullptr) const;
+    void set_stats(Stats_data&& data);
 
-    std::vector<float> time_stamp_;
-    Curve_stats stats_;
+    std::vector<Curve_annotations>
+    get_arrows(const Curve_selection& selection) const;
+    // The annotations of a view of the curve replace the content of `out`.
+    // The vectors are reused, so the drawing of a frame does not allocate
+    // once their sizes settle
+    void get_arrows(
+        const Curve_selection& selection,
+        const Point_store& view,
+        std::vector<Curve_annotations>& out) const;
+    std::vector<Scene_vertex_t>
+    get_markers(const Curve_selection& selection) const;
+    void get_markers(
+        const Curve_selection& selection,
+        const Point_store& view,
+        std::vector<Scene_vertex_t>& out) const;
 
-    // Annotations
-    std::vector<Arrow_type> arrows_;
-    std::vector<size_t>     markers_;
+private:
+    bool calculate_window_extrema(
+        const Point_store& points,
+        size_t first_window,
+        float kernel_size,
+        Window_extrema& out,
+        const std::atomic<bool>* is_canceled) const;
+    bool calculate_stats(
+        const Point_store& points,
+        const Window_extrema& extrema,
+        float max_movement,
+        float max_value,
+        Stats_data& data,
+        const std::atomic<bool>* is_canceled) const;
+    void calculate_speed(
+        const Point_store& points,
+        size_t first_segment,
+        Stats_data& data) const;
+    void calculate_dimensionality(
+        const Point_store& points,
+        const Window_extrema& extrema,
+        Stats_data& data) const;
+    void calculate_switches(
+        const Point_store& points,
+        size_t first_point,
+        Stats_data& data) const;
+    void calculate_annotations(
+        const Point_store& points,
+        Stats_data& data) const;
 
-    const static Color default_color_;
+    Point_store     points_;
+    Quantized_store quantized_;
+    Stats_data      stats_;
 };
@@ -1,12 +1,28 @@
 #pragma once
 // std
-#include <string>
+#include <cstdint>
 #include <vector>
 #include <tuple>
 #include <limits>
 
 struct Curve_stats
 {
+    // Active state variables of a point as a bit mask
+    typedef uint8_t Dim_mask;
+    enum : Dim_mask
+    {
+        Dim_x    = 1 << 0,
+        Dim_y    = 1 << 1,
+        Dim_z    = 1 << 2,
+        Dim_w    = 1 << 3,
+        All_dims = Dim_x | Dim_y | Dim_z | Dim_w
+    };
+
+    static int num_dims(Dim_mask dims)
+    {
+        return (dims & 1) + (dims >> 1 & 1) + (dims >> 2 & 1) + (dims >> 3 & 1);
+    }
+
     struct Range
     {
         typedef std::tuple<float, float> Min_and_max;
@@ -34,7 +50,7 @@ struct Curve_stats
     float min_speed, max_speed;
     // These two vectors should be of the size of the curve (number of points)
     std::vector<float> speed;
-    std::vector<std::string> dimensionality;
+    std::vector<Dim_mask> dimensionality;
     // Vectors bellow have the size depending from number of switches
     std::vector<size_t> switches_inds;
     std::vector<Range> range; 
@@ -0,0 +1,110 @@
+#include "Frame_arena.h"
+
+//******************************************************************************
+// Frame_arena
+//******************************************************************************
+
+Frame_arena::Frame_arena(size_t initial_size/* = 1 << 20*/)
+    : block_(std::make_unique<unsigned char[]>(initial_size))
+    , capacity_(initial_size)
+    , used_(0)
+    , overflow_bytes_(0)
+{
+}
+
+//******************************************************************************
+// ~Frame_arena
+//******************************************************************************
+
+Frame_arena::~Frame_arena()
+{
+    release_overflows();
+}
+
+//******************************************************************************
+// reset
+//******************************************************************************
+
+void Frame_arena::reset()
+{
+    if(overflow_bytes_ > 0)
+    {
+        release_overflows();
+
+        // Room for the whole frame and some growth
+        const size_t required = used_ + overflow_bytes_;
+        capacity_ = required + required / 2;
+        block_ = std::make_unique<unsigned char[]>(capacity_);
+
+        overflow_bytes_ = 0;
+    }
+
+    used_ = 0;
+}
+
+//******************************************************************************
+// capacity
+//******************************************************************************
+
+size_t Frame_arena::capacity() const
+{
+    return capacity_;
+}
+
+//******************************************************************************
+// do_allocate
+//******************************************************************************
+
+void* Frame_arena::do_allocate(size_t bytes, size_t alignment)
+{
+    void* ptr = block_.get() + used_;
+    size_t space = capacity_ - used_;
+    if(std::align(alignment, bytes, ptr, space))
+    {
+        used_ = capacity_ - space + bytes;
+        return ptr;
+    }
+
+    // The block is full, the heap takes the rest of the frame
+    ptr = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    overflows_.push_back({ptr, bytes, alignment});
+    overflow_bytes_ += bytes + alignment;
+
+    return ptr;
+}
+
+//******************************************************************************
+// do_deallocate
+//
+// The memory is released all at once by reset()
+//******************************************************************************
+
+void Frame_arena::do_deallocate(void*, size_t, size_t)
+{
+}
+
+//******************************************************************************
+// do_is_equal
+//******************************************************************************
+
+bool Frame_arena::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+//******************************************************************************
+// release_overflows
+//******************************************************************************
+
+void Frame_arena::release_overflows()
+{
+    for(const auto& o : overflows_)
+    {
+        std::pmr::new_delete_resource()->deallocate(
+            o.ptr,
+            o.bytes,
+            o.alignment);
+    }
+    overflows_.clear();
+}
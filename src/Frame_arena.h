@@ -0,0 +1,49 @@
+#pragma once
+// std
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// Memory for the temporary objects of one frame. An allocation takes the next
+// bytes of a single block and a deallocation does nothing, reset() makes the
+// whole block free again. A frame that needs more than the block gets the rest
+// from the heap, and the next reset() grows the block to the size the frame
+// needed, so the frames of a steady scene do not touch the heap
+class Frame_arena : public std::pmr::memory_resource
+{
+public:
+    explicit Frame_arena(size_t initial_size = 1 << 20);
+    ~Frame_arena() override;
+
+    Frame_arena(const Frame_arena&) = delete;
+    Frame_arena& operator=(const Frame_arena&) = delete;
+
+    // Releases every allocation made since the previous reset
+    void reset();
+
+    size_t capacity() const;
+
+private:
+    struct Overflow
+    {
+        void*  ptr;
+        size_t bytes;
+        size_t alignment;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void  do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+    bool  do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override;
+
+    void release_overflows();
+
+    std::unique_ptr<unsigned char[]> block_;
+    size_t capacity_;
+    size_t used_;
+
+    // Allocations that did not fit into the block
+    std::vector<Overflow> overflows_;
+    size_t overflow_bytes_;
+};
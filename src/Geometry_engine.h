@@ -25,6 +25,8 @@ public:
     ~Geometry_engine();
 
     void init_buffers();
+    // Removes the geometry, the arrays keep their memory for the next one
+    void clear();
 
     std::vector<TArray_data> data_array; // vertices + normals + colors
     std::vector<GLuint> indices;
@@ -71,6 +73,13 @@ void Geometry_engine<TArray_data>::init_buffers()
         GL_STATIC_DRAW);
 }
 
+template<class TArray_data>
+void Geometry_engine<TArray_data>::clear()
+{
+    data_array.clear();
+    indices.clear();
+}
+
 template<class TArray_data>
 Geometry_engine<TArray_data>::Geometry_engine(const Geometry_engine& other)
     : data_array(other.data_array)
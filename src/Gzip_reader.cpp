@@ -0,0 +1,213 @@
+#include "Gzip_reader.h"
+// std
+#include <fstream>
+// zlib
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace
+{
+// Blocks are large enough to be split between the parsing threads
+const size_t Block_size = 4 << 20;
+const size_t Num_blocks = 3;
+} // namespace
+
+//******************************************************************************
+// Gzip_reader
+//******************************************************************************
+
+Gzip_reader::Gzip_reader(const std::string& fname)
+    : file_(nullptr),
+      blocks_(Num_blocks),
+      next_read_(0),
+      next_write_(0),
+      is_first_read_(true),
+      has_error_(false),
+      stop_(false),
+      compressed_bytes_(0)
+{
+#ifdef USE_ZLIB
+    auto file = gzopen(fname.c_str(), "rb");
+    if(file == nullptr)
+        return;
+    gzbuffer(file, 1 << 18);
+    file_ = file;
+
+    for(auto& b : blocks_)
+        b.data.resize(Block_size);
+
+#ifndef __EMSCRIPTEN__
+    thread_ = std::thread(&Gzip_reader::decompression_loop, this);
+#endif
+#else
+    (void)fname;
+#endif
+}
+
+//******************************************************************************
+// ~Gzip_reader
+//******************************************************************************
+
+Gzip_reader::~Gzip_reader()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    condition_.notify_all();
+
+    if(thread_.joinable())
+        thread_.join();
+
+#ifdef USE_ZLIB
+    if(file_ != nullptr)
+        gzclose(static_cast<gzFile>(file_));
+#endif
+}
+
+//******************************************************************************
+// is_gzip
+//******************************************************************************
+
+bool Gzip_reader::is_gzip(const std::string& fname)
+{
+    std::ifstream stream(fname, std::ios::binary);
+    unsigned char signature[2] = {0, 0};
+    stream.read(reinterpret_cast<char*>(signature), sizeof(signature));
+
+    return stream.gcount() == 2 && signature[0] == 0x1f && signature[1] == 0x8b;
+}
+
+//******************************************************************************
+// is_open
+//******************************************************************************
+
+bool Gzip_reader::is_open() const
+{
+    return file_ != nullptr;
+}
+
+//******************************************************************************
+// has_error
+//******************************************************************************
+
+bool Gzip_reader::has_error() const
+{
+    return has_error_;
+}
+
+//******************************************************************************
+// next_block
+//******************************************************************************
+
+bool Gzip_reader::next_block(const char*& data, size_t& size)
+{
+    if(!is_open())
+        return false;
+
+#ifdef __EMSCRIPTEN__
+    // There is no decompression thread, the same block is filled every time
+    auto& block = blocks_.front();
+    if(!fill_block(block))
+        return false;
+#else
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        // The previous block can be filled again
+        if(!is_first_read_)
+        {
+            blocks_[next_read_].is_full = false;
+            next_read_ = (next_read_ + 1) % blocks_.size();
+            condition_.notify_all();
+        }
+        is_first_read_ = false;
+
+        condition_.wait(lock, [this]() {
+            return blocks_[next_read_].is_full;
+        });
+    }
+
+    // An empty block marks the end of the data
+    auto& block = blocks_[next_read_];
+    if(block.size == 0)
+        return false;
+#endif
+
+    data = block.data.data();
+    size = block.size;
+    return true;
+}
+
+//******************************************************************************
+// compressed_bytes
+//******************************************************************************
+
+size_t Gzip_reader::compressed_bytes() const
+{
+    return compressed_bytes_;
+}
+
+//******************************************************************************
+// decompression_loop
+//******************************************************************************
+
+void Gzip_reader::decompression_loop()
+{
+    while(true)
+    {
+        auto& block = blocks_[next_write_];
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this, &block]() {
+                return !block.is_full || stop_;
+            });
+            if(stop_)
+                return;
+        }
+
+        // The block is not accessed by the reader until it is marked as full
+        const bool has_data = fill_block(block);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            block.is_full = true;
+        }
+        condition_.notify_all();
+
+        if(!has_data)
+            return;
+        next_write_ = (next_write_ + 1) % blocks_.size();
+    }
+}
+
+//******************************************************************************
+// fill_block
+//******************************************************************************
+
+bool Gzip_reader::fill_block(Block& block)
+{
+    block.size = 0;
+#ifdef USE_ZLIB
+    auto file = static_cast<gzFile>(file_);
+    while(block.size < block.data.size() && !stop_)
+    {
+        const int num_read = gzread(
+            file,
+            block.data.data() + block.size,
+            static_cast<unsigned>(block.data.size() - block.size));
+        if(num_read <= 0)
+        {
+            // A truncated file is reported as an error at the end of the data
+            int error = Z_OK;
+            gzerror(file, &error);
+            if(num_read < 0 || error != Z_OK)
+                has_error_ = true;
+            break;
+        }
+        block.size += num_read;
+    }
+    compressed_bytes_ = static_cast<size_t>(gzoffset(file));
+#endif
+    return block.size > 0;
+}
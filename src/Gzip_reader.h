@@ -0,0 +1,67 @@
+#pragma once
+// std
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Streaming reader of gzip-compressed files. The decompressed data is read in
+// fixed-size blocks, and only a few blocks are kept in memory at a time. The
+// decompression runs on its own thread ahead of the reader, so it overlaps with
+// the processing of the blocks. In builds without thread support (Emscripten)
+// the blocks are decompressed by the reading thread. The reader is available
+// if the application is built with zlib (USE_ZLIB), otherwise no file can be
+// opened.
+class Gzip_reader
+{
+public:
+    explicit Gzip_reader(const std::string& fname);
+    ~Gzip_reader();
+
+    Gzip_reader(const Gzip_reader&) = delete;
+    Gzip_reader& operator=(const Gzip_reader&) = delete;
+
+    // Checks the gzip signature of the file
+    static bool is_gzip(const std::string& fname);
+
+    bool is_open() const;
+    // True if the file is damaged or truncated
+    bool has_error() const;
+
+    // Provides the next block of the decompressed data. The block stays valid
+    // until the next call. Returns false at the end of the data
+    bool next_block(const char*& data, size_t& size);
+
+    // Number of the compressed bytes that are decompressed so far
+    size_t compressed_bytes() const;
+
+private:
+    struct Block
+    {
+        std::vector<char> data;
+        size_t size = 0;
+        bool is_full = false;
+    };
+
+    void decompression_loop();
+    // Fills the block with the decompressed data. Returns false at the end of
+    // the data or on an error
+    bool fill_block(Block& block);
+
+    void* file_; // gzFile, the zlib header is not exposed
+
+    std::vector<Block> blocks_;
+    size_t next_read_;  // The block returned by the next next_block() call
+    size_t next_write_; // The block filled next by the decompression
+    bool is_first_read_;
+
+    std::atomic<bool> has_error_;
+    std::atomic<bool> stop_;
+    std::atomic<size_t> compressed_bytes_;
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::thread thread_;
+};
@@ -0,0 +1,77 @@
+#include "Mapped_file.h"
+// boost
+#include <boost/interprocess/exceptions.hpp>
+
+//******************************************************************************
+// Mapped_file
+//******************************************************************************
+
+Mapped_file::Mapped_file(const std::string& fname)
+{
+    open(fname);
+}
+
+//******************************************************************************
+// open
+//******************************************************************************
+
+bool Mapped_file::open(const std::string& fname)
+{
+    close();
+
+    try
+    {
+        mapping_ = boost::interprocess::file_mapping(
+            fname.c_str(), boost::interprocess::read_only);
+        region_ = boost::interprocess::mapped_region(
+            mapping_, boost::interprocess::read_only);
+    }
+    catch(const boost::interprocess::interprocess_exception&)
+    {
+        // Empty files cannot be mapped, they are reported as closed as well as
+        // files that do not exist
+        close();
+        return false;
+    }
+
+    is_open_ = true;
+    return true;
+}
+
+//******************************************************************************
+// close
+//******************************************************************************
+
+void Mapped_file::close()
+{
+    region_ = boost::interprocess::mapped_region();
+    mapping_ = boost::interprocess::file_mapping();
+    is_open_ = false;
+}
+
+//******************************************************************************
+// is_open
+//******************************************************************************
+
+bool Mapped_file::is_open() const
+{
+    return is_open_;
+}
+
+//******************************************************************************
+// data
+//******************************************************************************
+
+const char* Mapped_file::data() const
+{
+    return static_cast<const char*>(region_.get_address());
+}
+
+//******************************************************************************
+// size
+//******************************************************************************
+
+size_t Mapped_file::size() const
+{
+    return region_.get_size();
+}
@@ -0,0 +1,30 @@
+#pragma once
+// boost
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+// std
+#include <string>
+
+// Read-only memory mapping of a file. The whole file is mapped at once, so the
+// content can be accessed as a contiguous array of characters without copying
+class Mapped_file
+{
+public:
+    Mapped_file() = default;
+    Mapped_file(const std::string& fname);
+
+    Mapped_file(const Mapped_file&) = delete;
+    Mapped_file& operator=(const Mapped_file&) = delete;
+
+    bool open(const std::string& fname);
+    void close();
+
+    bool is_open() const;
+    const char* data() const;
+    size_t size() const;
+
+private:
+    boost::interprocess::file_mapping mapping_;
+    boost::interprocess::mapped_region region_;
+    bool is_open_ = false;
+};
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <memory_resource>
 #include <vector>
 
 // Internal representation of a mesh. Currently it is very similar to the .OBJ
-// format
+// format. All the arrays of a mesh take the memory from the resource given to
+// the constructor, the meshes built during a frame use the frame arena
 struct Mesh
 {
     struct Vertex
@@ -19,12 +21,39 @@ struct Mesh
     };
     struct Object
     {
-        typedef std::vector<Vertex> FaceType;
-        std::vector<FaceType> faces;
+        typedef std::pmr::polymorphic_allocator<Object> allocator_type;
+        typedef std::pmr::vector<Vertex> FaceType;
+
+        explicit Object(const allocator_type& alloc = {})
+            : faces(alloc)
+        {
+        }
+        Object(const Object& other, const allocator_type& alloc = {})
+            : faces(other.faces, alloc)
+        {
+        }
+        Object(Object&& other, const allocator_type& alloc)
+            : faces(std::move(other.faces), alloc)
+        {
+        }
+        Object(Object&& other) = default;
+        Object& operator=(const Object& other) = default;
+        Object& operator=(Object&& other) = default;
+
+        std::pmr::vector<FaceType> faces;
     };
 
-    std::vector<glm::vec3> vertices;
-    std::vector<glm::vec3> normals;
-    std::vector<glm::vec4> colors;
-    std::vector<Object> objects;
+    explicit Mesh(
+        std::pmr::memory_resource* mem = std::pmr::get_default_resource())
+        : vertices(mem)
+        , normals(mem)
+        , colors(mem)
+        , objects(mem)
+    {
+    }
+
+    std::pmr::vector<glm::vec3> vertices;
+    std::pmr::vector<glm::vec3> normals;
+    std::pmr::vector<glm::vec4> colors;
+    std::pmr::vector<Object> objects;
 };
@@ -85,28 +85,28 @@ void Mesh_generator::cylinder(
         mesh.normals.push_back(rotation * normal);
     }
 
-    Mesh::Object object;
+    // The object and its faces are created in place, so they take the memory
+    // of the mesh
+    auto& object = mesh.objects.emplace_back();
+    object.faces.reserve(2 * num_verts);
     // creating faces
     for(unsigned int i = 0; i < num_verts; ++i)
     {
         auto vert_shift = first_vert + 2 * i;
         auto norm_shift = first_norm + 2 * i;
 
-        Mesh::Object::FaceType f1;
+        auto& f1 = object.faces.emplace_back();
+        f1.reserve(3);
         f1.emplace_back(Mesh::Vertex(vert_shift, norm_shift));
         f1.emplace_back(Mesh::Vertex(vert_shift + 2, norm_shift + 2));
         f1.emplace_back(Mesh::Vertex(vert_shift + 1, norm_shift + 1));
 
-        Mesh::Object::FaceType f2;
+        auto& f2 = object.faces.emplace_back();
+        f2.reserve(3);
         f2.emplace_back(Mesh::Vertex(vert_shift + 1, norm_shift + 1));
         f2.emplace_back(Mesh::Vertex(vert_shift + 2, norm_shift + 2));
         f2.emplace_back(Mesh::Vertex(vert_shift + 3, norm_shift + 3));
-
-        object.faces.push_back(f1);
-        object.faces.push_back(f2);
     }
-
-    mesh.objects.push_back(object);
 }
 
 void Mesh_generator::cylinder_v2(
@@ -188,28 +188,26 @@ void Mesh_generator::cylinder_v2(
         mesh.normals.push_back(rotation * normal);
     }
 
-    Mesh::Object object;
+    auto& object = mesh.objects.emplace_back();
+    object.faces.reserve(2 * num_verts);
     // creating faces
     for(unsigned int i = 0; i < num_verts; ++i)
     {
         auto vert_shift = first_vert + 2 * i;
         auto norm_shift = first_norm + 2 * i;
 
-        Mesh::Object::FaceType f1;
+        auto& f1 = object.faces.emplace_back();
+        f1.reserve(3);
         f1.emplace_back(Mesh::Vertex(vert_shift, norm_shift));
         f1.emplace_back(Mesh::Vertex(vert_shift + 2, norm_shift + 2));
         f1.emplace_back(Mesh::Vertex(vert_shift + 1, norm_shift + 1));
 
-        Mesh::Object::FaceType f2;
+        auto& f2 = object.faces.emplace_back();
+        f2.reserve(3);
         f2.emplace_back(Mesh::Vertex(vert_shift + 1, norm_shift + 1));
         f2.emplace_back(Mesh::Vertex(vert_shift + 2, norm_shift + 2));
         f2.emplace_back(Mesh::Vertex(vert_shift + 3, norm_shift + 3));
-
-        object.faces.push_back(f1);
-        object.faces.push_back(f2);
     }
-
-    mesh.objects.push_back(object);
 }
 
 Mesh Mesh_generator::cylinder_v2(
@@ -293,7 +291,7 @@ void Mesh_generator::sphere(
         return (first_norm + i * (rings + 1) + j);
     };
 
-    Mesh::Object object;
+    auto& object = mesh.objects.emplace_back();
     // Optimization: resize the face array to its final size
     object.faces.resize(2 * segments * rings);
 
@@ -302,6 +300,7 @@ void Mesh_generator::sphere(
         for(unsigned int j = 0; j < rings; ++j)
         {
             Mesh::Object::FaceType& f1 = object.faces[2 * (i * rings + j)];
+            f1.reserve(3);
             f1.emplace_back(Mesh::Vertex(vert_index(i, j), norm_index(i, j)));
             f1.emplace_back(
                 Mesh::Vertex(vert_index(i, j + 1), norm_index(i, j + 1)));
@@ -309,6 +308,7 @@ void Mesh_generator::sphere(
                 Mesh::Vertex(vert_index(i + 1, j), norm_index(i + 1, j)));
 
             Mesh::Object::FaceType& f2 = object.faces[2 * (i * rings + j) + 1];
+            f2.reserve(3);
             f2.emplace_back(Mesh::Vertex(
                 vert_index(i + 1, j + 1), norm_index(i + 1, j + 1)));
             f2.emplace_back(
@@ -317,6 +317,4 @@ void Mesh_generator::sphere(
                 Mesh::Vertex(vert_index(i, j + 1), norm_index(i, j + 1)));
         }
     }
-
-    mesh.objects.push_back(object);
 }
@@ -0,0 +1,305 @@
+#include "Point_ranking.h"
+// local
+#include "Thread_pool.h"
+// std
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace
+{
+// Segments with more points are split in rounds, the farthest point of a
+// segment is searched in chunks of this size in parallel. Smaller segments
+// are ranked by a task each
+const size_t Chunk_size = 16384;
+// The distances are computed for a block of points at once, so the loop
+// over the columns can be vectorized
+const size_t Block_size = 256;
+
+// A part of the curve between two kept points
+struct Segment
+{
+    size_t first, last;
+    float tolerance; // Of the point the part was split at
+};
+
+// The farthest point found in a part of a segment
+struct Farthest
+{
+    size_t index;
+    double distance;
+};
+
+//******************************************************************************
+// find_farthest
+//
+// Finds the point in [begin, end) that is the farthest from the segment, the
+// first one of the equally far ones. The squared distance to the closest
+// point of the segment is computed in double precision and in the same order
+// of operations as boost::geometry::simplify does, so both keep the same
+// points. The three cases of the closest point are computed for every point
+// and selected without branches
+//******************************************************************************
+
+Farthest find_farthest(
+    const Point_store& points,
+    const Segment& segment,
+    size_t begin,
+    size_t end)
+{
+    const float* c[4];
+    double p1[4], p2[4], v[4];
+    for(size_t k = 0; k < 4; ++k)
+    {
+        c[k] = points.coord(k).data();
+        p1[k] = c[k][segment.first];
+        p2[k] = c[k][segment.last];
+        v[k] = p2[k] - p1[k];
+    }
+    const double vv = v[0] * v[0] + (v[1] * v[1] + (v[2] * v[2] + v[3] * v[3]));
+
+    Farthest farthest = {begin, -1.0};
+    double distances[Block_size];
+    for(size_t block = begin; block < end; block += Block_size)
+    {
+        const size_t n = std::min(Block_size, end - block);
+        const float *x = c[0] + block, *y = c[1] + block,
+                    *z = c[2] + block, *w = c[3] + block;
+        for(size_t j = 0; j < n; ++j)
+        {
+            const double px = x[j], py = y[j], pz = z[j], pw = w[j];
+
+            const double w0 = px - p1[0], w1 = py - p1[1],
+                         w2 = pz - p1[2], w3 = pw - p1[3];
+            const double wv = w0 * v[0] + (w1 * v[1] + (w2 * v[2] + w3 * v[3]));
+            const double to_first = w0 * w0 + w1 * w1 + w2 * w2 + w3 * w3;
+
+            const double e0 = px - p2[0], e1 = py - p2[1],
+                         e2 = pz - p2[2], e3 = pw - p2[3];
+            const double to_last = e0 * e0 + e1 * e1 + e2 * e2 + e3 * e3;
+
+            const double b = wv / vv;
+            const double d0 = px - (p1[0] + v[0] * b),
+                         d1 = py - (p1[1] + v[1] * b),
+                         d2 = pz - (p1[2] + v[2] * b),
+                         d3 = pw - (p1[3] + v[3] * b);
+            const double to_line = d0 * d0 + d1 * d1 + d2 * d2 + d3 * d3;
+
+            const double beyond = vv <= wv ? to_last : to_line;
+            distances[j] = wv <= 0.0 ? to_first : beyond;
+        }
+
+        for(size_t j = 0; j < n; ++j)
+        {
+            if(farthest.distance < distances[j])
+                farthest = {block + j, distances[j]};
+        }
+    }
+
+    return farthest;
+}
+
+//******************************************************************************
+// split
+//
+// Ranks the farthest point of the segment and adds the segments on both sides
+// of it
+//******************************************************************************
+
+void split(
+    const Segment& segment,
+    const Farthest& farthest,
+    std::vector<float>& tolerances,
+    std::vector<Segment>& segments)
+{
+    const size_t i = farthest.index;
+    tolerances[i] = std::min(
+        static_cast<float>(std::sqrt(farthest.distance)), segment.tolerance);
+
+    if(i - segment.first > 1)
+        segments.push_back({segment.first, i, tolerances[i]});
+    if(segment.last - i > 1)
+        segments.push_back({i, segment.last, tolerances[i]});
+}
+
+//******************************************************************************
+// rank_segment
+//
+// Splits the segment until no point is left between the ends of the parts,
+// the parts are kept on a stack instead of the recursion
+//******************************************************************************
+
+void rank_segment(
+    const Point_store& points,
+    const Segment& segment,
+    std::vector<float>& tolerances)
+{
+    std::vector<Segment> segments = {segment};
+    while(!segments.empty())
+    {
+        const Segment s = segments.back();
+        segments.pop_back();
+
+        split(
+            s,
+            find_farthest(points, s, s.first + 1, s.last),
+            tolerances,
+            segments);
+    }
+}
+} // namespace
+
+//******************************************************************************
+// Point_ranking
+//******************************************************************************
+
+Point_ranking::Point_ranking()
+{
+}
+
+//******************************************************************************
+// Point_ranking
+//
+// The long segments are split in rounds, all the chunks of their points are
+// searched in parallel. The parts shorter than a chunk are independent tasks,
+// the longest ones are taken first
+//******************************************************************************
+
+Point_ranking::Point_ranking(const Point_store& points)
+{
+    const size_t num_points = points.size();
+    const float infinity = std::numeric_limits<float>::infinity();
+    auto& pool = Thread_pool::global();
+
+    std::vector<float> tolerances(num_points, infinity);
+    std::vector<Segment> segments, short_segments;
+    if(num_points > 2)
+        segments.push_back({0, num_points - 1, infinity});
+
+    struct Chunk
+    {
+        size_t segment;
+        size_t begin, end;
+    };
+    std::vector<Chunk> chunks;
+    std::vector<Farthest> found;
+    while(!segments.empty())
+    {
+        chunks.clear();
+        for(size_t s = 0; s < segments.size(); ++s)
+        {
+            const auto& segment = segments[s];
+            if(segment.last - segment.first <= Chunk_size)
+            {
+                short_segments.push_back(segment);
+                continue;
+            }
+
+            for(size_t begin = segment.first + 1; begin < segment.last;
+                begin += Chunk_size)
+            {
+                chunks.push_back(
+                    {s, begin, std::min(begin + Chunk_size, segment.last)});
+            }
+        }
+
+        found.resize(chunks.size());
+        pool.parallel_for(chunks.size(), [&](size_t i) {
+            const auto& chunk = chunks[i];
+            found[i] = find_farthest(
+                points, segments[chunk.segment], chunk.begin, chunk.end);
+        });
+
+        // The chunks of a segment are in order, the first farthest point wins
+        std::vector<Segment> next_segments;
+        for(size_t i = 0; i < chunks.size();)
+        {
+            const size_t s = chunks[i].segment;
+            Farthest farthest = found[i];
+            for(++i; i < chunks.size() && chunks[i].segment == s; ++i)
+            {
+                if(farthest.distance < found[i].distance)
+                    farthest = found[i];
+            }
+            split(segments[s], farthest, tolerances, next_segments);
+        }
+        segments = std::move(next_segments);
+    }
+
+    std::sort(
+        short_segments.begin(),
+        short_segments.end(),
+        [](const Segment& a, const Segment& b) {
+            return a.last - a.first > b.last - b.first;
+        });
+    pool.parallel_for(short_segments.size(), [&](size_t i) {
+        rank_segment(points, short_segments[i], tolerances);
+    });
+
+    order_.resize(num_points);
+    std::iota(order_.begin(), order_.end(), 0);
+    std::stable_sort(order_.begin(), order_.end(), [&](uint32_t a, uint32_t b) {
+        return tolerances[a] > tolerances[b];
+    });
+
+    tolerances_.resize(num_points);
+    for(size_t i = 0; i < num_points; ++i)
+        tolerances_[i] = tolerances[order_[i]];
+}
+
+//******************************************************************************
+// size
+//******************************************************************************
+
+size_t Point_ranking::size() const
+{
+    return order_.size();
+}
+
+//******************************************************************************
+// empty
+//******************************************************************************
+
+bool Point_ranking::empty() const
+{
+    return order_.empty();
+}
+
+//******************************************************************************
+// count
+//******************************************************************************
+
+size_t Point_ranking::count(float max_deviation) const
+{
+    const auto end = std::lower_bound(
+        tolerances_.begin(),
+        tolerances_.end(),
+        max_deviation,
+        [](float tolerance, float d) { return tolerance > d; });
+
+    return static_cast<size_t>(end - tolerances_.begin());
+}
+
+//******************************************************************************
+// get_indices
+//******************************************************************************
+
+void Point_ranking::get_indices(
+    float max_deviation,
+    std::vector<uint32_t>& out) const
+{
+    const size_t n = count(max_deviation);
+    out.assign(order_.begin(), order_.begin() + n);
+    std::sort(out.begin(), out.end());
+}
+
+//******************************************************************************
+// memory_size
+//******************************************************************************
+
+size_t Point_ranking::memory_size() const
+{
+    return order_.capacity() * sizeof(uint32_t) +
+           tolerances_.capacity() * sizeof(float);
+}
@@ -0,0 +1,36 @@
+#pragma once
+// Local
+#include "Point_store.h"
+// std
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Ranking of the points of a curve by the Ramer-Douglas-Peucker hierarchy.
+// Every point gets the largest tolerance the simplification keeps it for, the
+// distance of the point from the split segment, but not more than the
+// tolerance of the point the segment was split at. The simplification with
+// any tolerance is then the points with a larger tolerance, the algorithm is
+// not run again. The first and the last point are always kept
+class Point_ranking
+{
+public:
+    Point_ranking();
+    explicit Point_ranking(const Point_store& points);
+
+    // Number of the ranked points
+    size_t size() const;
+    bool   empty() const;
+
+    // Number of the points kept by the simplification with the tolerance
+    size_t count(float max_deviation) const;
+    // Indices of the points kept by the simplification in increasing order
+    void get_indices(float max_deviation, std::vector<uint32_t>& out) const;
+
+    size_t memory_size() const;
+
+private:
+    // The points by decreasing tolerance, the tolerances in the same order
+    std::vector<uint32_t> order_;
+    std::vector<float>    tolerances_;
+};
@@ -0,0 +1,391 @@
+#include "Point_store.h"
+// std
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace
+{
+// Number of floats in the alignment, capacities are multiples of it
+const size_t Floats_per_block = Point_store::Alignment / sizeof(float);
+
+//******************************************************************************
+// allocate
+//******************************************************************************
+
+float* allocate(size_t num_floats)
+{
+    if(num_floats == 0)
+        return nullptr;
+
+    return static_cast<float*>(::operator new(
+        num_floats * sizeof(float),
+        std::align_val_t(Point_store::Alignment)));
+}
+
+//******************************************************************************
+// release
+//******************************************************************************
+
+void release(float* data)
+{
+    if(data != nullptr)
+        ::operator delete(data, std::align_val_t(Point_store::Alignment));
+}
+} // namespace
+
+//******************************************************************************
+// Point_store
+//******************************************************************************
+
+Point_store::Point_store()
+    : data_(nullptr),
+      size_(0),
+      capacity_(0)
+{
+}
+
+//******************************************************************************
+// Point_store
+//******************************************************************************
+
+Point_store::Point_store(const Point_store& other)
+    : Point_store()
+{
+    operator=(other);
+}
+
+//******************************************************************************
+// Point_store
+//******************************************************************************
+
+Point_store::Point_store(Point_store&& other) noexcept
+    : data_(other.data_),
+      size_(other.size_),
+      capacity_(other.capacity_)
+{
+    other.data_ = nullptr;
+    other.size_ = other.capacity_ = 0;
+}
+
+//******************************************************************************
+// operator=
+//******************************************************************************
+
+Point_store& Point_store::operator=(const Point_store& other)
+{
+    if(this == &other)
+        return *this;
+
+    // A copy gets just the capacity it needs
+    clear();
+    reserve(other.size_);
+    for(size_t i = 0; i < Num_columns && other.size_ > 0; ++i)
+        std::memcpy(column(i), other.column(i), other.size_ * sizeof(float));
+    size_ = other.size_;
+
+    return *this;
+}
+
+//******************************************************************************
+// operator=
+//******************************************************************************
+
+Point_store& Point_store::operator=(Point_store&& other) noexcept
+{
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
+
+    return *this;
+}
+
+//******************************************************************************
+// ~Point_store
+//******************************************************************************
+
+Point_store::~Point_store()
+{
+    release(data_);
+}
+
+//******************************************************************************
+// size
+//******************************************************************************
+
+size_t Point_store::size() const
+{
+    return size_;
+}
+
+//******************************************************************************
+// empty
+//******************************************************************************
+
+bool Point_store::empty() const
+{
+    return size_ == 0;
+}
+
+//******************************************************************************
+// reserve
+//******************************************************************************
+
+void Point_store::reserve(size_t n)
+{
+    if(n > capacity_)
+        reallocate(n);
+}
+
+//******************************************************************************
+// resize
+//
+// New points are zero
+//******************************************************************************
+
+void Point_store::resize(size_t n)
+{
+    reserve(n);
+    for(size_t i = 0; i < Num_columns && n > size_; ++i)
+        std::fill(column(i) + size_, column(i) + n, 0.f);
+    size_ = n;
+}
+
+//******************************************************************************
+// clear
+//******************************************************************************
+
+void Point_store::clear()
+{
+    size_ = 0;
+}
+
+//******************************************************************************
+// push_back
+//******************************************************************************
+
+void Point_store::push_back(float t, const Scene_vertex_t& v)
+{
+    push_back(t, v(0), v(1), v(2), v(3), v.size() > 4 ? v(4) : 0.f);
+}
+
+//******************************************************************************
+// push_back
+//******************************************************************************
+
+void Point_store::push_back(float t, float x, float y, float z, float w, float h)
+{
+    if(size_ == capacity_)
+        reallocate(std::max(2 * capacity_, Floats_per_block));
+
+    column(0)[size_] = t;
+    column(1)[size_] = x;
+    column(2)[size_] = y;
+    column(3)[size_] = z;
+    column(4)[size_] = w;
+    column(5)[size_] = h;
+    ++size_;
+}
+
+//******************************************************************************
+// time
+//******************************************************************************
+
+Span<float> Point_store::time()
+{
+    return Span<float>(column(0), size_);
+}
+
+//******************************************************************************
+// time
+//******************************************************************************
+
+Span<const float> Point_store::time() const
+{
+    return Span<const float>(column(0), size_);
+}
+
+//******************************************************************************
+// coord
+//******************************************************************************
+
+Span<float> Point_store::coord(size_t i)
+{
+    return Span<float>(column(i + 1), size_);
+}
+
+//******************************************************************************
+// coord
+//******************************************************************************
+
+Span<const float> Point_store::coord(size_t i) const
+{
+    return Span<const float>(column(i + 1), size_);
+}
+
+//******************************************************************************
+// vertex
+//******************************************************************************
+
+Scene_vertex_t Point_store::vertex(size_t i) const
+{
+    Scene_vertex_t v(Num_coords);
+    for(size_t k = 0; k < Num_coords; ++k)
+        v(k) = column(k + 1)[i];
+
+    return v;
+}
+
+//******************************************************************************
+// translate
+//******************************************************************************
+
+void Point_store::translate(
+    const boost::numeric::ublas::vector<double>& translate)
+{
+    const size_t num_coords = std::min(translate.size(), Num_coords);
+    for(size_t k = 0; k < num_coords; ++k)
+    {
+        float* c = column(k + 1);
+        const double d = translate(k);
+        for(size_t i = 0; i < size_; ++i)
+            c[i] = static_cast<float>(c[i] + d);
+    }
+}
+
+//******************************************************************************
+// scale
+//******************************************************************************
+
+void Point_store::scale(double scale_factor)
+{
+    for(size_t k = 0; k < Num_coords; ++k)
+    {
+        float* c = column(k + 1);
+        for(size_t i = 0; i < size_; ++i)
+            c[i] = static_cast<float>(c[i] * scale_factor);
+    }
+}
+
+//******************************************************************************
+// scale
+//******************************************************************************
+
+void Point_store::scale(
+    const boost::numeric::ublas::vector<double>& scale_factor)
+{
+    const size_t num_coords = std::min(scale_factor.size(), Num_coords);
+    for(size_t k = 0; k < num_coords; ++k)
+    {
+        float* c = column(k + 1);
+        const double s = scale_factor(k);
+        for(size_t i = 0; i < size_; ++i)
+            c[i] = static_cast<float>(c[i] * s);
+    }
+}
+
+//******************************************************************************
+// transform
+//******************************************************************************
+
+void Point_store::transform(const boost::numeric::ublas::matrix<float>& m)
+{
+    const size_t n = std::min(std::min(m.size1(), m.size2()), Num_coords);
+
+    float mat[Num_coords][Num_coords];
+    for(size_t r = 0; r < n; ++r)
+    {
+        for(size_t c = 0; c < n; ++c)
+            mat[r][c] = m(r, c);
+    }
+
+    float* c[Num_coords];
+    for(size_t k = 0; k < n; ++k)
+        c[k] = column(k + 1);
+
+    for(size_t i = 0; i < size_; ++i)
+    {
+        float in[Num_coords];
+        for(size_t k = 0; k < n; ++k)
+            in[k] = c[k][i];
+
+        for(size_t k = 0; k < n; ++k)
+        {
+            float sum = 0.f;
+            for(size_t r = 0; r < n; ++r)
+                sum += in[r] * mat[r][k];
+            c[k][i] = sum;
+        }
+    }
+}
+
+//******************************************************************************
+// get_boundaries
+//******************************************************************************
+
+void Point_store::get_boundaries(
+    Scene_vertex_t& origin,
+    Scene_vertex_t& size) const
+{
+    origin = Scene_vertex_t(Num_coords, 0.f);
+    size = Scene_vertex_t(Num_coords, 0.f);
+    if(size_ == 0)
+        return;
+
+    // The homogeneous coordinate is taken from the first point
+    for(size_t k = 0; k < Num_coords; ++k)
+    {
+        const float* c = column(k + 1);
+        if(k == Num_coords - 1)
+        {
+            origin(k) = c[0];
+            continue;
+        }
+
+        float min = c[0], max = c[0];
+        for(size_t i = 1; i < size_; ++i)
+        {
+            min = std::min(min, c[i]);
+            max = std::max(max, c[i]);
+        }
+        origin(k) = min;
+        size(k) = max - min;
+    }
+}
+
+//******************************************************************************
+// memory_size
+//******************************************************************************
+
+size_t Point_store::memory_size() const
+{
+    return Num_columns * capacity_ * sizeof(float);
+}
+
+//******************************************************************************
+// column
+//******************************************************************************
+
+float* Point_store::column(size_t i) const
+{
+    return data_ + i * capacity_;
+}
+
+//******************************************************************************
+// reallocate
+//******************************************************************************
+
+void Point_store::reallocate(size_t capacity)
+{
+    capacity = (capacity + Floats_per_block - 1) /
+               Floats_per_block * Floats_per_block;
+
+    float* data = allocate(Num_columns * capacity);
+    for(size_t i = 0; i < Num_columns && size_ > 0; ++i)
+        std::memcpy(data + i * capacity, column(i), size_ * sizeof(float));
+
+    release(data_);
+    data_ = data;
+    capacity_ = capacity;
+}
@@ -0,0 +1,69 @@
+#pragma once
+// Local
+#include "Scene_vertex_t.h"
+#include "Span.h"
+// boost
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+// std
+#include <cstddef>
+
+// Points of a curve stored column by column: the time stamps and the five
+// coordinates of the scene vertices (x, y, z, w and the homogeneous one). All
+// the columns live in a single allocation, every column starts at a 32-byte
+// boundary, so the loops over the columns can be vectorized
+class Point_store
+{
+public:
+    static constexpr size_t Num_coords = 5;
+    static constexpr size_t Alignment = 32; // In bytes
+
+    Point_store();
+    Point_store(const Point_store& other);
+    Point_store(Point_store&& other) noexcept;
+    Point_store& operator=(const Point_store& other);
+    Point_store& operator=(Point_store&& other) noexcept;
+    ~Point_store();
+
+    size_t size() const;
+    bool   empty() const;
+    void   reserve(size_t n);
+    void   resize(size_t n);
+    void   clear();
+
+    void push_back(float t, const Scene_vertex_t& v);
+    void push_back(float t, float x, float y, float z, float w, float h);
+
+    Span<float>       time();
+    Span<const float> time() const;
+    // Coordinates 0 to 3 are x, y, z, w, 4 is the homogeneous one
+    Span<float>       coord(size_t i);
+    Span<const float> coord(size_t i) const;
+
+    // Copy of a point as a scene vertex
+    Scene_vertex_t vertex(size_t i) const;
+
+    void translate(const boost::numeric::ublas::vector<double>& translate);
+    void scale(double scale_factor);
+    void scale(const boost::numeric::ublas::vector<double>& scale_factor);
+    // Multiplies every point as a row vector by the matrix, the same as
+    // prod(v, m). A matrix smaller than 5x5 transforms only the first
+    // coordinates
+    void transform(const boost::numeric::ublas::matrix<float>& m);
+
+    // Same as Vertex_object::get_boundaries
+    void get_boundaries(Scene_vertex_t& origin, Scene_vertex_t& size) const;
+
+    // Allocated bytes
+    size_t memory_size() const;
+
+private:
+    static constexpr size_t Num_columns = Num_coords + 1;
+
+    float* column(size_t i) const;
+    void   reallocate(size_t capacity);
+
+    float* data_;
+    size_t size_;
+    size_t capacity_; // Rounded up to keep the columns aligned
+};
@@ -0,0 +1,216 @@
+#include "Quantized_store.h"
+// std
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+const float Max_value = 65535.f;
+
+//******************************************************************************
+// quantize
+//******************************************************************************
+
+uint16_t quantize(float value)
+{
+    return static_cast<uint16_t>(
+        std::min(std::max(std::round(value), 0.f), Max_value));
+}
+} // namespace
+
+//******************************************************************************
+// Quantized_store
+//******************************************************************************
+
+Quantized_store::Quantized_store()
+    : h_(0.f)
+    , time_step_(0.f)
+{
+    std::fill(origin_, origin_ + Num_coords, 0.f);
+    std::fill(extent_, extent_ + Num_coords, 0.f);
+}
+
+//******************************************************************************
+// encode
+//******************************************************************************
+
+void Quantized_store::encode(const Point_store& points)
+{
+    clear();
+
+    const size_t n = points.size();
+    if(n == 0)
+        return;
+
+    Scene_vertex_t origin, size;
+    points.get_boundaries(origin, size);
+    h_ = origin(Num_coords);
+
+    for(size_t k = 0; k < Num_coords; ++k)
+    {
+        origin_[k] = origin(k);
+        extent_[k] = size(k);
+
+        const auto c = points.coord(k);
+        const float scale = extent_[k] > 0.f ? Max_value / extent_[k] : 0.f;
+
+        coords_[k].resize(n);
+        for(size_t i = 0; i < n; ++i)
+            coords_[k][i] = quantize((c[i] - origin_[k]) * scale);
+    }
+
+    // The longest step between two time stamps takes the largest value
+    const auto t = points.time();
+    float max_step = 0.f;
+    for(size_t i = 1; i < n; ++i)
+        max_step = std::max(max_step, t[i] - t[i - 1]);
+    time_step_ = max_step / Max_value;
+
+    // Every step is taken from the decoded previous time stamp, so the errors
+    // do not add up. A step between two different time stamps is at least
+    // one, so the decoded ones are increasing as well
+    block_times_.reserve((n + Block_size - 1) / Block_size);
+    time_steps_.resize(n);
+    float decoded = 0.f;
+    for(size_t i = 0; i < n; ++i)
+    {
+        if(i % Block_size == 0)
+        {
+            block_times_.push_back(t[i]);
+            time_steps_[i] = 0;
+            decoded = t[i];
+            continue;
+        }
+
+        uint16_t step = 0;
+        if(time_step_ > 0.f)
+        {
+            step = quantize((t[i] - decoded) / time_step_);
+            if(step == 0 && t[i] > t[i - 1])
+                step = 1;
+        }
+
+        time_steps_[i] = step;
+        decoded = decoded + static_cast<float>(step) * time_step_;
+    }
+}
+
+//******************************************************************************
+// decode
+//******************************************************************************
+
+void Quantized_store::decode(Point_store& points) const
+{
+    const size_t n = size();
+    points.resize(n);
+
+    for(size_t k = 0; k < Num_coords; ++k)
+    {
+        auto c = points.coord(k);
+        const uint16_t* q = coords_[k].data();
+        const float origin = origin_[k];
+        const float step = extent_[k] / Max_value;
+
+        for(size_t i = 0; i < n; ++i)
+            c[i] = origin + static_cast<float>(q[i]) * step;
+    }
+
+    auto h = points.coord(Num_coords);
+    std::fill(h.begin(), h.end(), h_);
+
+    auto t = points.time();
+    for(size_t b = 0; b < block_times_.size(); ++b)
+    {
+        const size_t first = b * Block_size;
+        const size_t last = std::min(first + Block_size, n);
+
+        float decoded = block_times_[b];
+        t[first] = decoded;
+        for(size_t i = first + 1; i < last; ++i)
+        {
+            decoded = decoded + static_cast<float>(time_steps_[i]) * time_step_;
+            t[i] = decoded;
+        }
+    }
+}
+
+//******************************************************************************
+// clear
+//******************************************************************************
+
+void Quantized_store::clear()
+{
+    for(auto& c : coords_)
+        std::vector<uint16_t>().swap(c);
+    std::vector<float>().swap(block_times_);
+    std::vector<uint16_t>().swap(time_steps_);
+}
+
+//******************************************************************************
+// size
+//******************************************************************************
+
+size_t Quantized_store::size() const
+{
+    return time_steps_.size();
+}
+
+//******************************************************************************
+// empty
+//******************************************************************************
+
+bool Quantized_store::empty() const
+{
+    return time_steps_.empty();
+}
+
+//******************************************************************************
+// time
+//******************************************************************************
+
+float Quantized_store::time(size_t i) const
+{
+    const size_t first = i / Block_size * Block_size;
+
+    float decoded = block_times_[i / Block_size];
+    for(size_t j = first + 1; j <= i; ++j)
+        decoded = decoded + static_cast<float>(time_steps_[j]) * time_step_;
+
+    return decoded;
+}
+
+//******************************************************************************
+// get_boundaries
+//******************************************************************************
+
+void Quantized_store::get_boundaries(
+    Scene_vertex_t& origin,
+    Scene_vertex_t& size) const
+{
+    origin = Scene_vertex_t(Point_store::Num_coords, 0.f);
+    size = Scene_vertex_t(Point_store::Num_coords, 0.f);
+    if(empty())
+        return;
+
+    for(size_t k = 0; k < Num_coords; ++k)
+    {
+        origin(k) = origin_[k];
+        size(k) = extent_[k];
+    }
+    origin(Num_coords) = h_;
+}
+
+//******************************************************************************
+// memory_size
+//******************************************************************************
+
+size_t Quantized_store::memory_size() const
+{
+    size_t bytes = sizeof(*this);
+    for(const auto& c : coords_)
+        bytes += c.capacity() * sizeof(uint16_t);
+    bytes += block_times_.capacity() * sizeof(float);
+    bytes += time_steps_.capacity() * sizeof(uint16_t);
+
+    return bytes;
+}
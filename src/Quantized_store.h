@@ -0,0 +1,49 @@
+#pragma once
+// Local
+#include "Point_store.h"
+#include "Scene_vertex_t.h"
+// std
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Compact copy of a Point_store. The coordinates x, y, z, w are 16-bit fixed
+// point values in the bounding box of the points. The time stamps are split
+// into blocks: the first time stamp of a block is kept as it is, the others
+// are 16-bit steps from the previous one. The homogeneous coordinate has to
+// be the same for all the points, as it is in the loaded curves. A point takes
+// 10 bytes instead of 24, the error of a coordinate is below 1/131070 of the
+// box
+class Quantized_store
+{
+public:
+    static constexpr size_t Num_coords = 4;
+    static constexpr size_t Block_size = 64;
+
+    Quantized_store();
+
+    void encode(const Point_store& points);
+    // Overwrites the points with the decoded ones, block by block
+    void decode(Point_store& points) const;
+    void clear();
+
+    size_t size() const;
+    bool   empty() const;
+
+    // Decodes a single time stamp
+    float time(size_t i) const;
+
+    // The box of the encoding, the same as Point_store::get_boundaries
+    void get_boundaries(Scene_vertex_t& origin, Scene_vertex_t& size) const;
+
+    size_t memory_size() const;
+
+private:
+    std::vector<uint16_t> coords_[Num_coords];
+    float origin_[Num_coords], extent_[Num_coords];
+    float h_;
+
+    std::vector<float>    block_times_;
+    std::vector<uint16_t> time_steps_;
+    float time_step_; // The duration of a step
+};
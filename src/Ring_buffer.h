@@ -0,0 +1,154 @@
+#pragma once
+// std
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+// Fixed-capacity buffer of the latest items. Adding an item to a full buffer
+// overwrites the oldest one, so the memory does not grow however many items
+// are added. The items are indexed from the oldest one
+template<typename T>
+class Ring_buffer
+{
+public:
+    explicit Ring_buffer(size_t capacity = 0);
+
+    // Returns true if the oldest item was overwritten
+    bool push_back(const T& value);
+    // Removes the oldest items
+    void pop_front(size_t count = 1);
+    void clear();
+
+    size_t size() const;
+    size_t capacity() const;
+    bool empty() const;
+
+    const T& operator[](size_t i) const;
+    const T& front() const;
+    const T& back() const;
+
+private:
+    std::vector<T> items_;
+    size_t first_ = 0;
+    size_t size_ = 0;
+};
+
+//******************************************************************************
+// Ring_buffer
+//******************************************************************************
+
+template<typename T>
+Ring_buffer<T>::Ring_buffer(size_t capacity/* = 0*/)
+    : items_(capacity)
+{
+}
+
+//******************************************************************************
+// push_back
+//******************************************************************************
+
+template<typename T>
+bool Ring_buffer<T>::push_back(const T& value)
+{
+    if(items_.empty())
+        return false;
+
+    if(size_ == items_.size())
+    {
+        items_[first_] = value;
+        first_ = (first_ + 1) % items_.size();
+        return true;
+    }
+
+    items_[(first_ + size_) % items_.size()] = value;
+    ++size_;
+    return false;
+}
+
+//******************************************************************************
+// pop_front
+//******************************************************************************
+
+template<typename T>
+void Ring_buffer<T>::pop_front(size_t count/* = 1*/)
+{
+    count = std::min(count, size_);
+    if(count == 0)
+        return;
+
+    first_ = (first_ + count) % items_.size();
+    size_ -= count;
+}
+
+//******************************************************************************
+// clear
+//******************************************************************************
+
+template<typename T>
+void Ring_buffer<T>::clear()
+{
+    first_ = 0;
+    size_ = 0;
+}
+
+//******************************************************************************
+// size
+//******************************************************************************
+
+template<typename T>
+size_t Ring_buffer<T>::size() const
+{
+    return size_;
+}
+
+//******************************************************************************
+// capacity
+//******************************************************************************
+
+template<typename T>
+size_t Ring_buffer<T>::capacity() const
+{
+    return items_.size();
+}
+
+//******************************************************************************
+// empty
+//******************************************************************************
+
+template<typename T>
+bool Ring_buffer<T>::empty() const
+{
+    return size_ == 0;
+}
+
+//******************************************************************************
+// operator[]
+//******************************************************************************
+
+template<typename T>
+const T& Ring_buffer<T>::operator[](size_t i) const
+{
+    assert(i < size_);
+    return items_[(first_ + i) % items_.size()];
+}
+
+//******************************************************************************
+// front
+//******************************************************************************
+
+template<typename T>
+const T& Ring_buffer<T>::front() const
+{
+    return (*this)[0];
+}
+
+//******************************************************************************
+// back
+//******************************************************************************
+
+template<typename T>
+const T& Ring_buffer<T>::back() const
+{
+    return (*this)[size_ - 1];
+}
@@ -1,10 +1,18 @@
 #include "Scene.h"
 // local
+#include "Binary_trajectory.h"
+#include "Gzip_reader.h"
 #include "Mesh.h"
+#include "Thread_pool.h"
+#include "Trajectory_cache.h"
+#include "Trajectory_index.h"
 // std
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
 #include <fstream>
+#include <system_error>
 // boost
-#include <boost/algorithm/string.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/assignment.hpp>
@@ -14,10 +22,32 @@
 //******************************************************************************
 
 Scene::Scene(std::shared_ptr<Scene_state> state)
-    : state_(state)
+    : state_(state),
+      tesseract_size_(200.f),
+      columns_(Trajectory_parser::Default_columns),
+      id_column_(Trajectory_parser::No_column),
+      has_time_window_(false),
+      t_begin_(0.f),
+      t_end_(0.f),
+      max_deviation_(0.f)
 {
 }
 
+//******************************************************************************
+// ~Scene
+//******************************************************************************
+
+Scene::~Scene()
+{
+    if(loading_)
+    {
+        cancel_loading();
+        loading_->result.wait();
+    }
+    cancel_stats_preview();
+    cancel_simplification();
+}
+
 //******************************************************************************
 // load_ode
 //******************************************************************************
@@ -27,85 +57,329 @@ void Scene::load_ode(
     float cuve_min_rad,
     float tesseract_size/* = 200.f*/)
 {
-    assert(state_);
-    if(state_ == nullptr)
-        return;
+    load_ode_async(fnames, cuve_min_rad, tesseract_size);
+    if(loading_)
+    {
+        loading_->result.wait();
+        finish_loading();
+    }
+}
 
-    // Remove all previous curves
-    state_->curves.clear();
-    // Reset size of the tesseract
-    for(auto& s : state_->tesseract_size)
-        s = tesseract_size;
+//******************************************************************************
+// load_ode
+//******************************************************************************
 
-    // The aggregative origin and size for all curves
-    Scene_vertex_t total_origin(5), total_size(5);
-    for(char i = 0; i < 5; ++i)
+void Scene::load_ode(
+    const std::vector<Trajectory_buffer>& buffers,
+    float cuve_min_rad,
+    float tesseract_size/* = 200.f*/)
+{
+    load_ode_async(buffers, cuve_min_rad, tesseract_size);
+    if(loading_)
     {
-        total_origin(i) = std::numeric_limits<float>::max();
-        total_size(i)   = std::numeric_limits<float>::min();
+        loading_->result.wait();
+        finish_loading();
     }
+}
 
-    std::vector<std::shared_ptr<Curve>> curves;
-    
-    // Load curves from files and calculate statistics
-    for(auto& fn: fnames)
-    {
-        // Load curves
-        auto curve = load_curve(fn);
-        if(!curve)
-            continue;
+//******************************************************************************
+// load_ode_async
+//******************************************************************************
 
-        Scene_vertex_t origin, size;
-        curve->get_boundaries(origin, size);
+void Scene::load_ode_async(
+    const std::vector<std::string>& fnames,
+    float cuve_min_rad,
+    float tesseract_size/* = 200.f*/)
+{
+    start_loading(fnames, {}, cuve_min_rad, tesseract_size);
+}
 
-        for(char i = 0; i < 5; ++i)
-        {
-            if(total_origin(i) > origin(i)) total_origin(i) = origin(i);
-            if(total_size(i)   < size(i)  ) total_size(i)   = size(i);
-        }
+//******************************************************************************
+// load_ode_async
+//******************************************************************************
+
+void Scene::load_ode_async(
+    const std::vector<Trajectory_buffer>& buffers,
+    float cuve_min_rad,
+    float tesseract_size/* = 200.f*/)
+{
+    start_loading({}, buffers, cuve_min_rad, tesseract_size);
+}
+
+//******************************************************************************
+// reload_ode_async
+//******************************************************************************
+
+void Scene::reload_ode_async(
+    float cuve_min_rad,
+    float tesseract_size/* = 200.f*/)
+{
+    // The lists are copied as start_loading replaces them
+    const auto fnames = fnames_;
+    const auto buffers = buffers_;
+    start_loading(fnames, buffers, cuve_min_rad, tesseract_size);
+}
+
+//******************************************************************************
+// start_loading
+//******************************************************************************
+
+void Scene::start_loading(
+    const std::vector<std::string>& fnames,
+    const std::vector<Trajectory_buffer>& buffers,
+    float cuve_min_rad,
+    float tesseract_size)
+{
+    assert(state_);
+    if(state_ == nullptr)
+        return;
 
-        curves.push_back(std::move(curve));
+    if(loading_)
+    {
+        cancel_loading();
+        loading_->result.wait();
+        loading_.reset();
     }
+    stop_stream();
 
-    if(!state_->scale_tesseract)
+    fnames_ = fnames;
+    buffers_ = buffers;
+    tesseract_size_ = tesseract_size;
+
+    // Only the columns of the loaded files are kept
     {
-        float max_size = std::numeric_limits<float>::min();
-        for(char i = 0; i < 4; ++i)
+        std::lock_guard<std::mutex> lock(file_columns_mutex_);
+        for(auto it = file_columns_.begin(); it != file_columns_.end();)
         {
-            if(max_size < total_size(i)) max_size = total_size(i);
+            if(std::find(fnames.begin(), fnames.end(), it->first) ==
+               fnames.end())
+            {
+                it = file_columns_.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
         }
+    }
 
-        for(char i = 0; i < 4; ++i)
-        {
-            state_->tesseract_size[i] =
-                tesseract_size * total_size[i] / max_size;
-        }
+    auto job = std::make_unique<Loading_job>();
+    job->fnames = fnames;
+    job->buffers = buffers;
+    job->columns = columns_;
+    job->id_column = id_column_;
+    job->has_time_window = has_time_window_;
+    job->t_begin = t_begin_;
+    job->t_end = t_end_;
+    job->cuve_min_rad = cuve_min_rad;
+    max_deviation_ = cuve_min_rad;
+    job->tesseract_size = tesseract_size;
+    job->scale_tesseract = state_->scale_tesseract;
+    job->stationary_epsilon = state_->stationary_epsilon;
+    job->quantize_curves = state_->quantize_curves;
+    job->stat_kernel_size = state_->stat_kernel_size;
+    job->stat_max_movement = state_->stat_max_movement;
+    job->stat_max_value = state_->stat_max_value;
+
+    for(const auto& fname : fnames)
+    {
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(fname, ec);
+        if(!ec)
+            job->total_bytes += static_cast<size_t>(size);
     }
+    for(const auto& buffer : buffers)
+        job->total_bytes += buffer.size();
 
-    Scene_vertex_t scale(5);
-    scale[0] = state_->tesseract_size[0] / total_size[0];
-    scale[1] = state_->tesseract_size[1] / total_size[1];
-    scale[2] = state_->tesseract_size[2] / total_size[2];
-    scale[3] = state_->tesseract_size[3] / total_size[3];
-    scale[4] = 1;
+#ifdef __EMSCRIPTEN__
+    // There are no threads in the browser, the job is run in finish_loading()
+    const auto policy = std::launch::deferred;
+#else
+    const auto policy = std::launch::async;
+#endif
+    auto& job_ref = *job;
+    job->result = std::async(policy, [this, &job_ref]() {
+        return run_loading(job_ref);
+    });
+
+    loading_ = std::move(job);
+}
+
+//******************************************************************************
+// set_columns
+//******************************************************************************
+
+bool Scene::set_columns(const Trajectory_parser::Columns& columns)
+{
+    if(!Trajectory_parser::is_complete(columns))
+        return false;
+
+    columns_ = columns;
+    return true;
+}
+
+//******************************************************************************
+// columns
+//******************************************************************************
+
+const Trajectory_parser::Columns& Scene::columns() const
+{
+    return columns_;
+}
+
+//******************************************************************************
+// set_id_column
+//******************************************************************************
+
+void Scene::set_id_column(size_t column)
+{
+    id_column_ = column;
+}
+
+//******************************************************************************
+// id_column
+//******************************************************************************
+
+size_t Scene::id_column() const
+{
+    return id_column_;
+}
+
+//******************************************************************************
+// set_time_window
+//******************************************************************************
+
+void Scene::set_time_window(float t_begin, float t_end)
+{
+    has_time_window_ = true;
+    t_begin_ = std::min(t_begin, t_end);
+    t_end_ = std::max(t_begin, t_end);
+}
+
+//******************************************************************************
+// clear_time_window
+//******************************************************************************
+
+void Scene::clear_time_window()
+{
+    has_time_window_ = false;
+}
+
+//******************************************************************************
+// has_time_window
+//******************************************************************************
+
+bool Scene::has_time_window() const
+{
+    return has_time_window_;
+}
+
+//******************************************************************************
+// is_loading
+//******************************************************************************
+
+bool Scene::is_loading() const
+{
+    return loading_ != nullptr;
+}
+
+//******************************************************************************
+// loading_progress
+//******************************************************************************
 
-    for(auto& c : curves)
+float Scene::loading_progress() const
+{
+    if(!loading_)
+        return 0.f;
+
+    // Reading of the files and processing of the curves are considered to take
+    // half of the time each
+    float progress = 0.f;
+    if(loading_->total_bytes > 0)
     {
-        c->translate_vertices(-0.5f * total_size - total_origin);
-        c->scale_vertices(scale);
+        progress += 0.5f * std::min(
+            1.f,
+            static_cast<float>(loading_->progress.bytes) /
+                loading_->total_bytes);
+    }
 
-        auto curve = std::make_shared<Curve>(
-            c->get_simpified_curve(cuve_min_rad));
-        curve->update_stats(
-            state_->stat_kernel_size,
-            state_->stat_max_movement,
-            state_->stat_max_value);
-        state_->curves.push_back(std::move(curve));
+    const size_t num_curves = loading_->num_curves;
+    if(num_curves > 0)
+    {
+        progress += 0.5f *
+            static_cast<float>(loading_->num_processed_curves) / num_curves;
+    }
+
+    return progress;
+}
+
+//******************************************************************************
+// cancel_loading
+//******************************************************************************
+
+void Scene::cancel_loading()
+{
+    if(loading_)
+        loading_->progress.is_canceled = true;
+}
+
+//******************************************************************************
+// is_loading_canceled
+//******************************************************************************
+
+bool Scene::is_loading_canceled() const
+{
+    return loading_ && loading_->progress.is_canceled;
+}
+
+//******************************************************************************
+// finish_loading
+//******************************************************************************
+
+bool Scene::finish_loading()
+{
+    if(!loading_)
+        return false;
+
+    std::unique_ptr<Loaded_scene> loaded;
+
+    const auto status =
+        loading_->result.wait_for(std::chrono::seconds::zero());
+    if(status == std::future_status::timeout)
+    {
+        // Show the preview while the full resolution curves are loaded
+        std::lock_guard<std::mutex> lock(loading_->preview_mutex);
+        if(!loading_->preview || loading_->progress.is_canceled)
+            return false;
+        loaded = std::move(loading_->preview);
+    }
+    else
+    {
+        // A deferred job is run here
+        loaded = loading_->result.get();
+        loading_.reset();
+        if(!loaded)
+            return false;
     }
 
-    // Save curve origin and size to the class members
+    // A running simplification belongs to the previous curves
+    cancel_simplification();
+
+    // Replace all previous curves
+    state_->curves = std::move(loaded->curves);
+    source_curves_ = std::move(loaded->source_curves);
+    state_->overview_curve = std::move(loaded->overview_curve);
+    state_->tesseract_size = loaded->tesseract_size;
+    followed_files_ = std::move(loaded->followed_files);
+    translate_ = loaded->translate;
+    scale_ = loaded->scale;
+
     create_tesseract();
 
+    // A running preview is computed again for the new curves
+    if(cancel_stats_preview())
+        preview_stats();
+
     if(state_->curves.size() > 0)
     {
         // Set selection (currently we take the range of the first curve, but
@@ -115,44 +389,1566 @@ void Scene::load_ode(
         state_->curve_selection->t_start = first_curve->t_min();
         state_->curve_selection->t_end = first_curve->t_max();
     }
+
+    return true;
 }
 
 //******************************************************************************
-// load_curve
+// preview_stats
 //******************************************************************************
 
-std::shared_ptr<Curve> Scene::load_curve(std::string fname)
+void Scene::preview_stats()
 {
-    std::ifstream stream(fname);
-    if(!stream.is_open())
-        return nullptr;
+    assert(state_);
+    if(state_ == nullptr)
+        return;
 
-    auto curve = std::make_shared<Curve>();
+    cancel_stats_preview();
+
+    auto job = std::make_unique<Stats_job>();
+    job->curves = state_->curves;
+    job->kernel_size = state_->stat_kernel_size;
+    job->max_movement = state_->stat_max_movement;
+    job->max_value = state_->stat_max_value;
+
+#ifdef __EMSCRIPTEN__
+    // There are no threads in the browser, the job is run in
+    // finish_stats_preview()
+    const auto policy = std::launch::deferred;
+#else
+    const auto policy = std::launch::async;
+#endif
+    auto& job_ref = *job;
+    job->result = std::async(policy, [this, &job_ref]() {
+        return run_stats_preview(job_ref);
+    });
+
+    stats_job_ = std::move(job);
+}
+
+//******************************************************************************
+// is_previewing_stats
+//******************************************************************************
+
+bool Scene::is_previewing_stats() const
+{
+    return stats_job_ != nullptr;
+}
+
+//******************************************************************************
+// finish_stats_preview
+//******************************************************************************
+
+bool Scene::finish_stats_preview()
+{
+    if(!stats_job_)
+        return false;
+
+    const auto status =
+        stats_job_->result.wait_for(std::chrono::seconds::zero());
+    if(status == std::future_status::timeout)
+        return false;
+
+    // A deferred job is run here
+    auto job = std::move(stats_job_);
+    if(!job->result.get())
+        return false;
+
+    // All the curves get the new statistics in the same frame
+    for(size_t i = 0; i < job->curves.size(); ++i)
+        job->curves[i]->set_stats(std::move(job->stats[i]));
+
+    return true;
+}
+
+//******************************************************************************
+// run_stats_preview
+//
+// Runs on a background thread. The curves are not changed while the job runs,
+// only the window extrema of the scene are accessed. Returns false if the
+// preview is canceled
+//******************************************************************************
 
-    std::string line;
-    while(getline(stream, line))
+bool Scene::run_stats_preview(Stats_job& job)
+{
+    // Drop the extrema of the curves that do not exist anymore
+    for(auto it = window_extrema_.begin(); it != window_extrema_.end();)
     {
-        // Remove some characters to make it easier to load files we get from
-        // Wolfram Mathematica
-        boost::erase_all(line, "\"{");
-        boost::erase_all(line, "}\"");
-        boost::replace_all(line, ", ", " ");
-        boost::replace_all(line, "*^", "e");
+        if(it->first.expired())
+            it = window_extrema_.erase(it);
+        else
+            ++it;
+    }
 
-        std::vector<std::string> vals;
-        boost::split(vals, line, boost::is_any_of("\t, "));
-        if(vals.size() == 5)
+    // The map is not changed by the workers
+    const size_t num_curves = job.curves.size();
+    std::vector<Curve::Window_extrema*> extrema(num_curves);
+    std::vector<char> is_complete(num_curves, false);
+    for(size_t i = 0; i < num_curves; ++i)
+    {
+        std::weak_ptr<const Curve> curve = job.curves[i];
+        auto it = window_extrema_.find(curve);
+        if(it != window_extrema_.end() &&
+           it->second.kernel_size == job.kernel_size)
         {
-            float t = std::stof(vals[0]);
-            Scene_vertex_t p(5);
-            p <<= std::stof(vals[1]), std::stof(vals[2]), std::stof(vals[3]),
-                std::stof(vals[4]), 1;
+            is_complete[i] = true;
+        }
+        extrema[i] = &window_extrema_[curve];
+    }
 
-            curve->add_point(p, t);
+    job.stats.resize(num_curves);
+    Thread_pool::global().parallel_for(num_curves, [&](size_t i) {
+        const auto& curve = *job.curves[i];
+        if(!is_complete[i])
+        {
+            is_complete[i] = curve.calculate_window_extrema(
+                job.kernel_size, *extrema[i], &job.is_canceled);
+        }
+        if(is_complete[i])
+        {
+            curve.calculate_stats(
+                *extrema[i],
+                job.max_movement,
+                job.max_value,
+                job.stats[i],
+                &job.is_canceled);
         }
+    });
+
+    // Incomplete extrema are computed again by the next preview
+    for(size_t i = 0; i < num_curves; ++i)
+    {
+        if(!is_complete[i])
+            window_extrema_.erase(job.curves[i]);
     }
 
-    return curve;
+    return !job.is_canceled;
+}
+
+//******************************************************************************
+// cancel_stats_preview
+//******************************************************************************
+
+bool Scene::cancel_stats_preview()
+{
+    if(!stats_job_)
+        return false;
+
+    stats_job_->is_canceled = true;
+    stats_job_->result.wait();
+    stats_job_.reset();
+
+    return true;
+}
+
+//******************************************************************************
+// simplify_curves
+//******************************************************************************
+
+void Scene::simplify_curves(float max_deviation)
+{
+    assert(state_);
+    if(state_ == nullptr)
+        return;
+
+    cancel_simplification();
+    if(source_curves_.empty())
+        return;
+
+    max_deviation_ = max_deviation;
+
+    auto job = std::make_unique<Simplification_job>();
+    job->source_curves = source_curves_;
+    job->max_deviation = max_deviation;
+    job->quantize_curves = state_->quantize_curves;
+    job->stat_kernel_size = state_->stat_kernel_size;
+    job->stat_max_movement = state_->stat_max_movement;
+    job->stat_max_value = state_->stat_max_value;
+
+#ifdef __EMSCRIPTEN__
+    // There are no threads in the browser, the job is run in
+    // finish_simplification()
+    const auto policy = std::launch::deferred;
+#else
+    const auto policy = std::launch::async;
+#endif
+    auto& job_ref = *job;
+    job->result = std::async(policy, [this, &job_ref]() {
+        return run_simplification(job_ref);
+    });
+
+    simplification_ = std::move(job);
+}
+
+//******************************************************************************
+// is_simplifying
+//******************************************************************************
+
+bool Scene::is_simplifying() const
+{
+    return simplification_ != nullptr;
+}
+
+//******************************************************************************
+// finish_simplification
+//******************************************************************************
+
+bool Scene::finish_simplification()
+{
+    if(!simplification_)
+        return false;
+
+    const auto status =
+        simplification_->result.wait_for(std::chrono::seconds::zero());
+    if(status == std::future_status::timeout)
+        return false;
+
+    // A deferred job is run here
+    auto job = std::move(simplification_);
+    if(!job->result.get())
+        return false;
+
+    // The followed files append their data to the new curves
+    for(auto& f : followed_files_)
+    {
+        for(size_t i = 0; i < job->source_curves.size(); ++i)
+        {
+            if(job->source_curves[i] == f.source)
+                f.curve = job->curves[i];
+        }
+    }
+    state_->curves = std::move(job->curves);
+
+    // The statistics of the new curves are computed with the thresholds of
+    // the job, a preview of other ones is computed again
+    if(cancel_stats_preview() ||
+       job->stat_kernel_size != state_->stat_kernel_size ||
+       job->stat_max_movement != state_->stat_max_movement ||
+       job->stat_max_value != state_->stat_max_value)
+    {
+        preview_stats();
+    }
+
+    return true;
+}
+
+//******************************************************************************
+// run_simplification
+//
+// Runs on a background thread. The source curves are not changed while the
+// job runs. The statistics are computed in the steps of the preview, so a
+// large curve notices the cancellation too. Returns false if the
+// simplification is canceled
+//******************************************************************************
+
+bool Scene::run_simplification(Simplification_job& job)
+{
+    job.curves.resize(job.source_curves.size());
+    Thread_pool::global().parallel_for(job.source_curves.size(), [&](size_t i) {
+        if(job.is_canceled)
+            return;
+
+        const auto& source = *job.source_curves[i];
+        auto curve = std::make_shared<Curve>(source.curve->get_simpified_curve(
+            source.ranking, job.max_deviation));
+
+        Curve::Window_extrema extrema;
+        Curve::Stats_data stats;
+        if(job.is_canceled ||
+           !curve->calculate_window_extrema(
+               job.stat_kernel_size, extrema, &job.is_canceled) ||
+           !curve->calculate_stats(
+               extrema,
+               job.stat_max_movement,
+               job.stat_max_value,
+               stats,
+               &job.is_canceled))
+        {
+            return;
+        }
+        curve->set_stats(std::move(stats));
+
+        if(job.quantize_curves)
+            curve->quantize();
+        job.curves[i] = std::move(curve);
+    });
+
+    return !job.is_canceled;
+}
+
+//******************************************************************************
+// cancel_simplification
+//******************************************************************************
+
+bool Scene::cancel_simplification()
+{
+    if(!simplification_)
+        return false;
+
+    simplification_->is_canceled = true;
+    simplification_->result.wait();
+    simplification_.reset();
+
+    return true;
+}
+
+//******************************************************************************
+// run_loading
+//
+// Loads, normalizes and simplifies the curves. Runs on a background thread and
+// does not access the scene state. Returns nullptr if the loading is canceled
+//******************************************************************************
+
+std::unique_ptr<Scene::Loaded_scene> Scene::run_loading(Loading_job& job)
+{
+    const auto& fnames = job.fnames;
+    const auto& buffers = job.buffers;
+    const size_t num_sources = fnames.size() + buffers.size();
+    auto& is_canceled = job.progress.is_canceled;
+
+    // Files smaller than this are loaded quickly enough without a preview
+    const size_t min_preview_bytes = 64 << 20;
+    const size_t preview_points = 20000;
+
+    // Only a part of the files is parsed for a time window, so the window is
+    // loaded without a preview. The rows of an ensemble cannot be sampled
+    if(job.total_bytes >= min_preview_bytes &&
+       !job.has_time_window &&
+       job.id_column == Trajectory_parser::No_column)
+    {
+        std::vector<std::shared_ptr<Curve>> curves(num_sources);
+        std::vector<Scene_vertex_t> origins(num_sources),
+                                    sizes(num_sources);
+
+        Thread_pool::global().parallel_for(num_sources, [&](size_t i) {
+            Trajectory_data data;
+            if(!buffers.empty())
+            {
+                if(load_buffer(
+                       buffers[i], job.columns, preview_points, data, nullptr))
+                {
+                    curves[i] = create_curve(
+                        data, job.stationary_epsilon, origins[i], sizes[i]);
+                }
+                return;
+            }
+
+            const bool is_loaded = Binary_trajectory::is_binary(fnames[i]) ?
+                Binary_trajectory::load(
+                    fnames[i],
+                    data,
+                    job.columns,
+                    preview_points) :
+                Trajectory_parser::parse_file_sample(
+                    fnames[i],
+                    preview_points,
+                    data,
+                    job.columns);
+            if(!is_loaded)
+                return;
+            data.update_boundaries();
+            curves[i] = create_curve(
+                data, job.stationary_epsilon, origins[i], sizes[i]);
+        });
+
+        auto preview = build_scene(job, curves, origins, sizes, nullptr);
+        if(is_canceled)
+            return nullptr;
+
+        std::lock_guard<std::mutex> lock(job.preview_mutex);
+        job.preview = std::move(preview);
+    }
+
+    // Every ensemble holds many trajectories, which share the bounds and the
+    // normalization with the trajectories of the other files. The files are
+    // loaded one by one as every file is parsed in parallel
+    if(job.id_column != Trajectory_parser::No_column)
+    {
+        std::vector<std::shared_ptr<Curve>> curves;
+        std::vector<Scene_vertex_t> origins, sizes;
+        for(size_t i = 0; i < num_sources && !is_canceled; ++i)
+            load_ensemble(job, i, curves, origins, sizes);
+        if(is_canceled)
+            return nullptr;
+
+        auto result = build_scene(
+            job,
+            curves,
+            origins,
+            sizes,
+            &job.num_processed_curves);
+        if(is_canceled)
+            return nullptr;
+        return result;
+    }
+
+    // Load curves from files in parallel. Every file gets its own slot, so the
+    // order of the curves does not depend on the order the files are loaded
+    std::vector<std::shared_ptr<Curve>> loaded(num_sources);
+    std::vector<Scene_vertex_t> origins(num_sources), sizes(num_sources);
+    std::vector<size_t> file_sizes(num_sources);
+    std::vector<uint64_t> stamp_sizes(num_sources);
+    std::vector<int64_t> stamp_mtimes(num_sources);
+    std::vector<Trajectory_data> summaries(num_sources);
+
+    Thread_pool::global().parallel_for(num_sources, [&](size_t i) {
+        if(is_canceled)
+            return;
+
+        if(!buffers.empty())
+        {
+            Trajectory_data data;
+            if(!load_buffer(buffers[i], job.columns, 0, data, &job.progress))
+                return;
+
+            if(job.has_time_window)
+            {
+                Trajectory_data window;
+                cut_window(data, job.t_begin, job.t_end, window, summaries[i]);
+                data = std::move(window);
+            }
+            loaded[i] = create_curve(
+                data, job.stationary_epsilon, origins[i], sizes[i]);
+            return;
+        }
+
+        if(job.has_time_window)
+        {
+            Trajectory_data data;
+            if(load_window(fnames[i], job, data, summaries[i], &job.progress))
+                loaded[i] = create_curve(
+                data, job.stationary_epsilon, origins[i], sizes[i]);
+            return;
+        }
+
+        // The stamp is taken before the loading, so the data appended during
+        // the loading is read by the first update of the followed file
+        if(!Trajectory_cache::get_source_stamp(
+               fnames[i], stamp_sizes[i], stamp_mtimes[i]))
+        {
+            return;
+        }
+
+        loaded[i] = load_curve(
+            fnames[i],
+            job.columns,
+            job.stationary_epsilon,
+            origins[i],
+            sizes[i],
+            file_sizes[i],
+            &job.progress);
+    });
+
+    if(is_canceled)
+        return nullptr;
+
+    // Only the files are followed, and not for a time window as the appended
+    // data is out of the window
+    std::vector<Followed_file> followed_files;
+    for(size_t fi = 0; fi < fnames.size() && !job.has_time_window; ++fi)
+    {
+        if(!loaded[fi])
+            continue;
+
+        Followed_file followed;
+        followed.fname = fnames[fi];
+        followed.offset = file_sizes[fi];
+        followed.file_size = stamp_sizes[fi];
+        followed.file_mtime = stamp_mtimes[fi];
+        followed.columns = job.columns;
+        followed.stationary_epsilon = job.stationary_epsilon;
+        for(char i = 0; i < 4; ++i)
+            followed.extent[i] = sizes[fi](i);
+        followed_files.push_back(followed);
+    }
+
+    auto result = build_scene(
+        job,
+        loaded,
+        origins,
+        sizes,
+        &job.num_processed_curves);
+    if(is_canceled)
+        return nullptr;
+
+    for(size_t i = 0; i < followed_files.size(); ++i)
+    {
+        followed_files[i].curve = result->curves[i];
+        followed_files[i].source = result->source_curves[i];
+    }
+    result->followed_files = std::move(followed_files);
+
+    // The summary of the first file is the overview on the timeline. It is
+    // transformed the same way as the curves, but not simplified
+    for(size_t fi = 0; fi < loaded.size() && job.has_time_window; ++fi)
+    {
+        Scene_vertex_t origin, size;
+        auto overview = create_curve(summaries[fi], 0.f, origin, size);
+        if(!overview)
+            continue;
+
+        overview->translate_vertices(result->translate);
+        overview->scale_vertices(result->scale);
+        result->overview_curve = std::move(overview);
+        break;
+    }
+
+    return result;
+}
+
+//******************************************************************************
+// build_scene
+//
+// Normalizes the curves to the common bounding box, simplifies them and
+// computes the statistics. Empty slots of `curves` are skipped
+//******************************************************************************
+
+std::unique_ptr<Scene::Loaded_scene> Scene::build_scene(
+    Loading_job& job,
+    std::vector<std::shared_ptr<Curve>>& curves,
+    const std::vector<Scene_vertex_t>& origins,
+    const std::vector<Scene_vertex_t>& sizes,
+    std::atomic<size_t>* num_processed_curves)
+{
+    auto result = std::make_unique<Loaded_scene>();
+
+    // Reset size of the tesseract
+    for(auto& s : result->tesseract_size)
+        s = job.tesseract_size;
+
+    // The aggregative origin and size for all curves
+    Scene_vertex_t total_origin(5), total_size(5);
+    for(char i = 0; i < 5; ++i)
+    {
+        total_origin(i) = std::numeric_limits<float>::max();
+        total_size(i)   = std::numeric_limits<float>::min();
+    }
+
+    std::vector<std::shared_ptr<Curve>> source_curves;
+    for(size_t ci = 0; ci < curves.size(); ++ci)
+    {
+        if(!curves[ci])
+            continue;
+
+        const auto& origin = origins[ci];
+        const auto& size = sizes[ci];
+        for(char i = 0; i < 5; ++i)
+        {
+            if(total_origin(i) > origin(i)) total_origin(i) = origin(i);
+            if(total_size(i)   < size(i)  ) total_size(i)   = size(i);
+        }
+
+        source_curves.push_back(std::move(curves[ci]));
+    }
+    if(num_processed_curves != nullptr)
+        job.num_curves = source_curves.size();
+
+    auto& tesseract_size = result->tesseract_size;
+    if(!job.scale_tesseract)
+    {
+        float max_size = std::numeric_limits<float>::min();
+        for(char i = 0; i < 4; ++i)
+        {
+            if(max_size < total_size(i)) max_size = total_size(i);
+        }
+
+        for(char i = 0; i < 4; ++i)
+        {
+            tesseract_size[i] =
+                job.tesseract_size * total_size[i] / max_size;
+        }
+    }
+
+    Scene_vertex_t scale(5);
+    scale[0] = tesseract_size[0] / total_size[0];
+    scale[1] = tesseract_size[1] / total_size[1];
+    scale[2] = tesseract_size[2] / total_size[2];
+    scale[3] = tesseract_size[3] / total_size[3];
+    scale[4] = 1;
+
+    const Scene_vertex_t translate = -0.5f * total_size - total_origin;
+    result->translate = translate;
+    result->scale = scale;
+
+    // Normalize, simplify and compute statistics of every curve in parallel.
+    // The source curves are kept with the ranking of their points, so they
+    // can be simplified again with another tolerance
+    result->curves.resize(source_curves.size());
+    result->source_curves.resize(source_curves.size());
+    Thread_pool::global().parallel_for(source_curves.size(), [&](size_t i) {
+        if(job.progress.is_canceled)
+            return;
+
+        auto source = std::make_shared<Source_curve>();
+        source->curve = std::move(source_curves[i]);
+        auto& c = *source->curve;
+        c.translate_vertices(translate);
+        c.scale_vertices(scale);
+        source->ranking = Point_ranking(c.get_points());
+
+        auto curve = std::make_shared<Curve>(
+            c.get_simpified_curve(source->ranking, job.cuve_min_rad));
+        curve->update_stats(
+            job.stat_kernel_size,
+            job.stat_max_movement,
+            job.stat_max_value);
+        // The statistics are computed from the float points
+        if(job.quantize_curves)
+        {
+            curve->quantize();
+            c.quantize();
+        }
+        result->curves[i] = std::move(curve);
+        result->source_curves[i] = std::move(source);
+
+        if(num_processed_curves != nullptr)
+            ++*num_processed_curves;
+    });
+
+    return result;
+}
+
+//******************************************************************************
+// load_columns
+//
+// Takes the columns from the memory if they are already parsed, otherwise from
+// the binary cache or the file. Only the columns that are not in the memory
+// are parsed
+//******************************************************************************
+
+bool Scene::load_columns(
+    const std::string& fname,
+    const Trajectory_parser::Columns& columns,
+    Trajectory_data& out,
+    size_t& file_size,
+    Trajectory_parser::Progress* progress)
+{
+    // Only the parsing of the missing columns below leaves some of them empty
+    assert(Trajectory_parser::is_complete(columns));
+    if(!Trajectory_parser::is_complete(columns))
+        return false;
+
+    uint64_t current_size;
+    int64_t current_mtime;
+    if(!Trajectory_cache::get_source_stamp(fname, current_size, current_mtime))
+        return false;
+
+    // Binary files are converted directly, there is nothing to cache
+    if(Binary_trajectory::is_binary(fname))
+    {
+        if(!Binary_trajectory::load(fname, out, columns) || out.size() == 0)
+            return false;
+
+        file_size = static_cast<size_t>(current_size);
+        if(progress != nullptr)
+            progress->bytes += file_size;
+
+        out.update_boundaries();
+        return true;
+    }
+
+    // Copy of the known columns of the file, the columns themselves are shared
+    File_columns known;
+    {
+        std::lock_guard<std::mutex> lock(file_columns_mutex_);
+        auto it = file_columns_.find(fname);
+        // A file rewritten with the same size has another modification time
+        if(it != file_columns_.end() &&
+           it->second.file_size == current_size &&
+           it->second.file_mtime == current_mtime)
+        {
+            known = it->second;
+        }
+    }
+
+    Trajectory_parser::Columns missing;
+    missing.fill(Trajectory_parser::No_column);
+    size_t num_missing = 0;
+    for(auto c : columns)
+    {
+        if(known.columns.count(c) == 0 &&
+           std::find(missing.begin(), missing.end(), c) == missing.end())
+        {
+            missing[num_missing++] = c;
+        }
+    }
+
+    bool is_parsed = false, is_cached = false;
+    std::vector<Trajectory_parser::Row_offset> row_offsets;
+    if(num_missing == 0)
+    {
+        file_size = known.parsed_size;
+        if(progress != nullptr)
+            progress->bytes += file_size;
+    }
+    else if(known.columns.empty())
+    {
+        // The binary cache is used if it is up to date, otherwise the file is
+        // parsed and the cache is (re)created
+        if(Trajectory_cache::load(fname, out, &file_size, columns))
+        {
+            if(progress != nullptr)
+                progress->bytes += file_size;
+            is_cached = true;
+        }
+        else
+        {
+            if(!Trajectory_parser::parse_file(
+                    fname,
+                    out,
+                    &file_size,
+                    progress,
+                    columns,
+                    &row_offsets,
+                    Trajectory_index::Stride) ||
+               out.size() == 0)
+            {
+                return false;
+            }
+
+            is_parsed = true;
+        }
+
+        known.file_size = current_size;
+        known.file_mtime = current_mtime;
+        known.parsed_size = file_size;
+        known.num_rows = out.size();
+    }
+    else
+    {
+        // Only the missing columns are parsed
+        Trajectory_data parsed;
+        if(!Trajectory_parser::parse_file(
+                fname, parsed, &file_size, progress, missing))
+        {
+            return false;
+        }
+
+        // A line with a text in a new column is skipped, so the rows do not
+        // match the known columns anymore and all columns are parsed again
+        if(parsed.size() != known.num_rows)
+        {
+            {
+                std::lock_guard<std::mutex> lock(file_columns_mutex_);
+                file_columns_.erase(fname);
+            }
+            return load_columns(fname, columns, out, file_size, progress);
+        }
+
+        for(size_t i = 0; i < num_missing; ++i)
+        {
+            known.columns[missing[i]] =
+                std::make_shared<const std::vector<float>>(
+                    std::move(parsed.column(i)));
+        }
+    }
+
+    // Fill the output from the known columns
+    size_t num_new = 0;
+    for(size_t i = 0; i < columns.size(); ++i)
+    {
+        auto it = known.columns.find(columns[i]);
+        if(it != known.columns.end())
+            out.column(i) = *it->second;
+        else
+            ++num_new;
+    }
+
+    // Remember the new columns if the columns of all the files fit into the
+    // budget, otherwise the file is parsed again next time. The columns read
+    // from the cache are not remembered, the cache is as fast to read again
+    if(!is_cached)
+    {
+        std::lock_guard<std::mutex> lock(file_columns_mutex_);
+        file_columns_.erase(fname);
+
+        size_t total_size =
+            (known.columns.size() + num_new) * known.num_rows * sizeof(float);
+        for(const auto& f : file_columns_)
+        {
+            total_size +=
+                f.second.columns.size() * f.second.num_rows * sizeof(float);
+        }
+
+        if(total_size <= Max_file_columns_size)
+        {
+            for(size_t i = 0; i < columns.size(); ++i)
+            {
+                auto& column = known.columns[columns[i]];
+                if(!column)
+                {
+                    column =
+                        std::make_shared<const std::vector<float>>(
+                            out.column(i));
+                }
+            }
+            file_columns_[fname] = std::move(known);
+        }
+    }
+
+    if(out.size() == 0)
+        return false;
+
+    out.update_boundaries();
+#ifndef __EMSCRIPTEN__
+    // Files loaded in the browser are temporary, there is no need to cache them
+    if(is_parsed)
+    {
+        Trajectory_cache::save(fname, out, file_size, columns);
+
+        // Compressed files have no row offsets, they are not indexed
+        if(!row_offsets.empty())
+        {
+            Trajectory_index::Index index;
+            Trajectory_index::build(out, row_offsets, index);
+            Trajectory_index::save(fname, index, columns);
+        }
+    }
+#endif
+
+    return true;
+}
+
+//******************************************************************************
+// load_ensemble
+//
+// Parses an ensemble file or buffer and appends a curve for every trajectory
+// of it
+//******************************************************************************
+
+void Scene::load_ensemble(
+    Loading_job& job,
+    size_t source,
+    std::vector<std::shared_ptr<Curve>>& curves,
+    std::vector<Scene_vertex_t>& origins,
+    std::vector<Scene_vertex_t>& sizes)
+{
+    Trajectory_parser::Ensemble ensemble;
+    if(!job.buffers.empty())
+    {
+        const auto& buffer = job.buffers[source];
+        Trajectory_parser::parse_ensemble(
+            buffer.data(),
+            buffer.data() + buffer.size(),
+            job.id_column,
+            ensemble,
+            &job.progress,
+            job.columns);
+    }
+    else if(!Trajectory_parser::parse_ensemble_file(
+                job.fnames[source],
+                job.id_column,
+                ensemble,
+                &job.progress,
+                job.columns))
+    {
+        return;
+    }
+
+    const size_t first = curves.size();
+    const size_t num_members = ensemble.members.size();
+    curves.resize(first + num_members);
+    origins.resize(first + num_members);
+    sizes.resize(first + num_members);
+
+    Thread_pool::global().parallel_for(num_members, [&](size_t m) {
+        auto& data = ensemble.members[m];
+        data.update_boundaries();
+        if(job.has_time_window)
+        {
+            Trajectory_data window, summary;
+            cut_window(data, job.t_begin, job.t_end, window, summary);
+            data = std::move(window);
+        }
+
+        curves[first + m] = create_curve(
+            data,
+            job.stationary_epsilon,
+            origins[first + m],
+            sizes[first + m]);
+        // The member is not needed anymore
+        data = Trajectory_data();
+    });
+}
+
+//******************************************************************************
+// load_window
+//
+// Loads the points of the time window of the job and a coarse summary of the
+// whole file. The window is read from the binary cache or parsed with the help
+// of the index if possible, otherwise the whole file is loaded (which creates
+// the index) and the window is cut out of it. The boundaries of both outputs
+// are the ones of the whole file
+//******************************************************************************
+
+bool Scene::load_window(
+    const std::string& fname,
+    const Loading_job& job,
+    Trajectory_data& out,
+    Trajectory_data& summary,
+    Trajectory_parser::Progress* progress)
+{
+    const auto& columns = job.columns;
+
+    if(!Binary_trajectory::is_binary(fname))
+    {
+        bool is_loaded =
+            Trajectory_cache::load_window(
+                fname, job.t_begin, job.t_end, out, columns) &&
+            Trajectory_cache::load_summary(
+                fname, Trajectory_index::Stride, summary, columns);
+
+        Trajectory_index::Index index;
+        if(!is_loaded &&
+           Trajectory_index::load(fname, index, columns) &&
+           Trajectory_index::load_window(
+               fname, index, job.t_begin, job.t_end, out, columns))
+        {
+            summary = std::move(index.summary);
+            is_loaded = true;
+        }
+
+        if(is_loaded)
+        {
+            std::error_code ec;
+            const auto file_size = std::filesystem::file_size(fname, ec);
+            if(progress != nullptr && !ec)
+                progress->bytes += static_cast<size_t>(file_size);
+            return true;
+        }
+    }
+
+    Trajectory_data data;
+    size_t file_size;
+    if(!load_columns(fname, columns, data, file_size, progress))
+        return false;
+
+    cut_window(data, job.t_begin, job.t_end, out, summary);
+
+    return true;
+}
+
+//******************************************************************************
+// cut_window
+//
+// Copies the rows with the time in [t_begin, t_end] and every Stride-th row as
+// the summary. The boundaries of both outputs are the ones of the whole data
+//******************************************************************************
+
+void Scene::cut_window(
+    const Trajectory_data& data,
+    float t_begin,
+    float t_end,
+    Trajectory_data& out,
+    Trajectory_data& summary)
+{
+    if(data.size() == 0)
+        return;
+
+    const auto& time = data.time;
+    const size_t first =
+        std::lower_bound(time.begin(), time.end(), t_begin) - time.begin();
+    const size_t last = std::max(
+        first,
+        static_cast<size_t>(
+            std::upper_bound(time.begin(), time.end(), t_end) -
+            time.begin()));
+
+    auto add_summary_row = [&data, &summary](size_t row) {
+        summary.push_back(
+            data.time[row],
+            data.coords[0][row],
+            data.coords[1][row],
+            data.coords[2][row],
+            data.coords[3][row]);
+    };
+
+    const size_t stride = Trajectory_index::Stride;
+    summary.reserve(data.size() / stride + 1);
+    for(size_t row = 0; row < data.size(); row += stride)
+        add_summary_row(row);
+    if((data.size() - 1) % stride != 0)
+        add_summary_row(data.size() - 1);
+
+    for(size_t i = 0; i < 5; ++i)
+    {
+        const auto& c = data.column(i);
+        out.column(i).assign(c.begin() + first, c.begin() + last);
+    }
+
+    out.origin = summary.origin = data.origin;
+    out.extent = summary.extent = data.extent;
+}
+
+//******************************************************************************
+// load_buffer
+//
+// Parses or converts a trajectory in the memory. If `num_samples` is not zero,
+// only about this number of rows is read for a preview
+//******************************************************************************
+
+bool Scene::load_buffer(
+    const Trajectory_buffer& buffer,
+    const Trajectory_parser::Columns& columns,
+    size_t num_samples,
+    Trajectory_data& out,
+    Trajectory_parser::Progress* progress)
+{
+    const char* begin = buffer.data();
+    const char* end = begin + buffer.size();
+
+    if(Binary_trajectory::is_binary(buffer.name()))
+    {
+        if(!Binary_trajectory::load(
+               buffer.name(),
+               begin,
+               buffer.size(),
+               out,
+               columns,
+               num_samples))
+        {
+            return false;
+        }
+
+        if(progress != nullptr)
+            progress->bytes += buffer.size();
+    }
+    else if(num_samples > 0)
+    {
+        Trajectory_parser::parse_sample(begin, end, num_samples, out, columns);
+    }
+    else
+    {
+        Trajectory_parser::parse_parallel(begin, end, out, progress, columns);
+    }
+
+    if(out.size() == 0)
+        return false;
+
+    out.update_boundaries();
+    return true;
+}
+
+//******************************************************************************
+// load_curve
+//******************************************************************************
+
+std::shared_ptr<Curve> Scene::load_curve(
+    const std::string& fname,
+    const Trajectory_parser::Columns& columns,
+    float stationary_epsilon,
+    Scene_vertex_t& origin,
+    Scene_vertex_t& size,
+    size_t& file_size,
+    Trajectory_parser::Progress* progress/* = nullptr*/)
+{
+    // An up to date cache is copied right into the curve, so the columns are
+    // not copied to the heap first
+    auto curve = std::make_shared<Curve>();
+    std::array<float, 4> cache_origin, cache_extent;
+    if(Trajectory_cache::load_points(
+           fname,
+           stationary_epsilon,
+           curve->get_points(),
+           cache_origin,
+           cache_extent,
+           &file_size,
+           columns) &&
+       curve->size() != 0)
+    {
+        if(progress != nullptr)
+            progress->bytes += file_size;
+
+        get_boundaries(cache_origin, cache_extent, origin, size);
+        return curve;
+    }
+
+    Trajectory_data data;
+    if(!load_columns(fname, columns, data, file_size, progress))
+        return nullptr;
+
+    return create_curve(data, stationary_epsilon, origin, size);
+}
+
+//******************************************************************************
+// create_curve
+//
+// Creates the curve from the data, which is compacted first: the runs of
+// nearly stationary points are replaced by their first and last points. The
+// boundaries of the data are kept, so the compaction does not change the
+// normalization of the scene
+//******************************************************************************
+
+std::shared_ptr<Curve> Scene::create_curve(
+    Trajectory_data& data,
+    float stationary_epsilon,
+    Scene_vertex_t& origin,
+    Scene_vertex_t& size)
+{
+    if(data.size() == 0)
+        return nullptr;
+
+    data.compact_stationary(stationary_epsilon);
+    get_boundaries(data.origin, data.extent, origin, size);
+
+    auto curve = std::make_shared<Curve>();
+    curve->add_points(data);
+
+    return curve;
+}
+
+//******************************************************************************
+// get_boundaries
+//
+// The boundaries are consistent with Vertex_object::get_boundaries
+//******************************************************************************
+
+void Scene::get_boundaries(
+    const std::array<float, 4>& data_origin,
+    const std::array<float, 4>& data_extent,
+    Scene_vertex_t& origin,
+    Scene_vertex_t& size)
+{
+    origin.resize(5);
+    size.resize(5);
+    for(char i = 0; i < 4; ++i)
+    {
+        origin(i) = data_origin[i];
+        size(i) = data_extent[i];
+    }
+    origin(4) = 1.f;
+    size(4) = 0.f;
+}
+
+//******************************************************************************
+// update_followed_files
+//******************************************************************************
+
+bool Scene::update_followed_files()
+{
+    // The loading replaces the followed files
+    if(loading_)
+        return false;
+
+    bool is_updated = false;
+    bool is_previewing = false, is_simplifying = false;
+
+    for(auto& f : followed_files_)
+    {
+        Trajectory_data data;
+        bool is_rewritten = false;
+        if(!read_appended_data(f, data, is_rewritten))
+        {
+            // The loaded points do not match the file anymore
+            if(is_rewritten)
+            {
+                reload_ode_async(max_deviation_, tesseract_size_);
+                return false;
+            }
+            continue;
+        }
+
+        data.extent = f.extent;
+        data.compact_stationary(f.stationary_epsilon);
+        if(data.size() == 0)
+            continue;
+
+        // Apply the same transformation as to the loaded curve
+        for(char i = 0; i < 4; ++i)
+        {
+            const double translate = translate_(i), scale = scale_(i);
+            for(auto& v : data.coords[i])
+                v = static_cast<float>((v + translate) * scale);
+        }
+
+        // A running preview or simplification is stopped before the curve is
+        // changed and is computed again for the new points
+        is_previewing = cancel_stats_preview() || is_previewing;
+        is_simplifying = cancel_simplification() || is_simplifying;
+        window_extrema_.erase(f.curve);
+
+        auto& curve = *f.curve;
+        const float old_t_max = curve.t_max();
+        const size_t first_new_point = curve.size();
+
+        // The homogeneous coordinate has to match the loaded points. The
+        // source curve gets the points too, they are kept by the next
+        // simplification
+        curve.add_points(data);
+        auto h = curve.get_points().coord(4);
+        std::fill(h.begin() + first_new_point, h.end(), h.front());
+        if(f.source)
+        {
+            auto& source = *f.source->curve;
+            const size_t first_source_point = source.size();
+            source.add_points(data);
+            auto source_h = source.get_points().coord(4);
+            std::fill(
+                source_h.begin() + first_source_point,
+                source_h.end(),
+                source_h.front());
+        }
+
+        curve.update_stats_tail(first_new_point);
+
+        // Extend the selection if the whole curve was selected
+        if(state_->curve_selection &&
+           state_->curve_selection->t_end >= old_t_max &&
+           f.curve == state_->selected_curve())
+        {
+            state_->curve_selection->t_end = curve.t_max();
+        }
+
+        is_updated = true;
+    }
+
+    if(is_simplifying)
+        simplify_curves(max_deviation_);
+    if(is_previewing)
+        preview_stats();
+
+    return is_updated;
+}
+
+//******************************************************************************
+// start_stream
+//******************************************************************************
+
+bool Scene::start_stream(
+    const std::string& address,
+    size_t max_points,
+    float max_duration/* = 0.f*/,
+    float tesseract_size/* = 200.f*/)
+{
+    assert(state_);
+    if(state_ == nullptr)
+        return false;
+
+    stop_stream();
+
+    auto stream = std::make_unique<Stream>();
+    stream->receiver = std::make_unique<Stream_receiver>(address);
+    if(!stream->receiver->is_open())
+        return false;
+
+    // The stream replaces the loaded files
+    if(loading_)
+    {
+        cancel_loading();
+        loading_->result.wait();
+        loading_.reset();
+    }
+    fnames_.clear();
+    buffers_.clear();
+    followed_files_.clear();
+    {
+        std::lock_guard<std::mutex> lock(file_columns_mutex_);
+        file_columns_.clear();
+    }
+
+    stream->window = Ring_buffer<Stream_point>(std::max<size_t>(max_points, 2));
+    stream->max_duration = max_duration;
+    stream->tesseract_size = tesseract_size;
+    stream_ = std::move(stream);
+
+    cancel_simplification();
+    state_->curves.clear();
+    source_curves_.clear();
+    state_->overview_curve.reset();
+    state_->curve_selection.reset();
+
+    return true;
+}
+
+//******************************************************************************
+// stop_stream
+//
+// The curve of the stream stays in the scene
+//******************************************************************************
+
+void Scene::stop_stream()
+{
+    stream_.reset();
+}
+
+//******************************************************************************
+// is_streaming
+//******************************************************************************
+
+bool Scene::is_streaming() const
+{
+    return stream_ != nullptr;
+}
+
+//******************************************************************************
+// is_stream_connected
+//******************************************************************************
+
+bool Scene::is_stream_connected() const
+{
+    return stream_ && stream_->receiver->is_connected();
+}
+
+//******************************************************************************
+// update_stream
+//******************************************************************************
+
+bool Scene::update_stream()
+{
+    if(!stream_)
+        return false;
+    auto& stream = *stream_;
+    auto& window = stream.window;
+
+    bool needs_rebuild = !stream.curve;
+    Trajectory_data received;
+
+    Stream_point p;
+    while(stream.receiver->pop(p))
+    {
+        // A new run of the solver starts a new curve
+        if(p.is_first)
+        {
+            window.clear();
+            received = Trajectory_data();
+            needs_rebuild = true;
+        }
+
+        if(window.push_back(p))
+            ++stream.num_dropped;
+        received.push_back(p.t, p.x, p.y, p.z, p.w);
+
+        // Points outside of the normalized box need other normalization
+        const float vals[4] = {p.x, p.y, p.z, p.w};
+        for(size_t i = 0; i < 4 && !needs_rebuild; ++i)
+        {
+            needs_rebuild = vals[i] < stream.origin[i] ||
+                            vals[i] > stream.origin[i] + stream.size[i];
+        }
+    }
+
+    if(stream.max_duration > 0.f)
+    {
+        while(window.size() > 1 &&
+              window.back().t - window.front().t > stream.max_duration)
+        {
+            window.pop_front();
+            ++stream.num_dropped;
+        }
+    }
+
+    if(received.size() == 0 && !needs_rebuild)
+        return false;
+    if(window.empty())
+        return false;
+
+    // A running preview is stopped before the curve is changed. A rebuilt
+    // curve gets the thresholds of the scene state anyway
+    const bool is_previewing = cancel_stats_preview();
+
+    // The curve keeps the dropped points until a quarter of the window is
+    // dropped, so the rebuilding cost is spread over many points. A curve
+    // that would be longer than the duration is rebuilt right away, so the
+    // statistics cover the sliding window only
+    const bool is_too_long =
+        stream.max_duration > 0.f && stream.curve &&
+        window.back().t - stream.curve->t_min() > stream.max_duration;
+    if(needs_rebuild || is_too_long ||
+       stream.num_dropped > std::max<size_t>(window.size() / 4, 1))
+    {
+        rebuild_stream_curve();
+        assert(stream.max_duration <= 0.f ||
+               stream.curve->t_max() - stream.curve->t_min() <=
+                   stream.max_duration);
+        return true;
+    }
+
+    for(char i = 0; i < 4; ++i)
+    {
+        const double translate = stream.translate(i), scale = stream.scale(i);
+        for(auto& v : received.coords[i])
+            v = static_cast<float>((v + translate) * scale);
+    }
+
+    auto& curve = *stream.curve;
+    const float old_t_max = curve.t_max();
+    const size_t first_new_point = curve.size();
+
+    window_extrema_.erase(stream.curve);
+    curve.add_points(received);
+    curve.update_stats_tail(first_new_point);
+    assert(stream.max_duration <= 0.f ||
+           curve.t_max() - curve.t_min() <= stream.max_duration);
+    if(is_previewing)
+        preview_stats();
+
+    // Extend the selection if the whole curve was selected
+    if(state_->curve_selection &&
+       state_->curve_selection->t_end >= old_t_max)
+    {
+        state_->curve_selection->t_end = curve.t_max();
+    }
+
+    return true;
+}
+
+//******************************************************************************
+// rebuild_stream_curve
+//
+// Creates the curve from the points of the window. The statistics are computed
+// for the window only
+//******************************************************************************
+
+void Scene::rebuild_stream_curve()
+{
+    auto& stream = *stream_;
+    const auto& window = stream.window;
+
+    // The selection follows the new points unless a part of the curve is
+    // selected
+    const bool is_whole_selected =
+        !stream.curve || !state_->curve_selection ||
+        state_->curve_selection->t_end >= stream.curve->t_max();
+
+    Trajectory_data data;
+    data.reserve(window.size());
+    for(size_t i = 0; i < window.size(); ++i)
+    {
+        const auto& p = window[i];
+        data.push_back(p.t, p.x, p.y, p.z, p.w);
+    }
+    data.update_boundaries();
+
+    // The margin keeps the normalization while the points stay close to the
+    // current boundaries
+    for(char i = 0; i < 4; ++i)
+    {
+        const float margin =
+            data.extent[i] > 0.f ? 0.1f * data.extent[i] : 1.f;
+        stream.origin[i] = data.origin[i] - margin;
+        stream.size[i] = data.extent[i] + 2.f * margin;
+    }
+
+    auto& tesseract_size = state_->tesseract_size;
+    float max_size = std::numeric_limits<float>::min();
+    for(char i = 0; i < 4; ++i)
+        max_size = std::max(max_size, stream.size[i]);
+    for(char i = 0; i < 4; ++i)
+    {
+        tesseract_size[i] = state_->scale_tesseract ?
+            stream.tesseract_size :
+            stream.tesseract_size * stream.size[i] / max_size;
+    }
+
+    stream.translate.resize(5);
+    stream.scale.resize(5);
+    for(char i = 0; i < 4; ++i)
+    {
+        stream.translate(i) = -0.5f * stream.size[i] - stream.origin[i];
+        stream.scale(i) = tesseract_size[i] / stream.size[i];
+    }
+    stream.translate(4) = 0.f;
+    stream.scale(4) = 1.f;
+
+    for(char i = 0; i < 4; ++i)
+    {
+        const double translate = stream.translate(i), scale = stream.scale(i);
+        for(auto& v : data.coords[i])
+            v = static_cast<float>((v + translate) * scale);
+    }
+
+    stream.curve = std::make_shared<Curve>();
+    stream.curve->add_points(data);
+    stream.curve->update_stats(
+        state_->stat_kernel_size,
+        state_->stat_max_movement,
+        state_->stat_max_value);
+    stream.num_dropped = 0;
+
+    // The stream curve is not simplified
+    cancel_simplification();
+    state_->curves = {stream.curve};
+    source_curves_.clear();
+    state_->overview_curve.reset();
+    create_tesseract();
+
+    if(is_whole_selected)
+    {
+        state_->curve_selection = std::make_unique<Curve_selection>();
+        state_->curve_selection->t_start = stream.curve->t_min();
+        state_->curve_selection->t_end = stream.curve->t_max();
+    }
+}
+
+//******************************************************************************
+// read_appended_data
+//
+// Parses complete lines appended to the file since the last read. A file that
+// got shorter, changed without growing or does not continue right after the
+// last read line is rewritten, then `is_rewritten` is set and nothing is read
+//******************************************************************************
+
+bool Scene::read_appended_data(
+    Followed_file& file,
+    Trajectory_data& out,
+    bool& is_rewritten)
+{
+    is_rewritten = false;
+
+    // Only the uncompressed text files are followed
+    if(Binary_trajectory::is_binary(file.fname) ||
+       Gzip_reader::is_gzip(file.fname))
+    {
+        return false;
+    }
+
+    uint64_t file_size;
+    int64_t file_mtime;
+    if(!Trajectory_cache::get_source_stamp(file.fname, file_size, file_mtime))
+        return false;
+    if(file_size == file.file_size && file_mtime == file.file_mtime)
+        return false;
+
+    if(file_size <= file.file_size || file_size < file.offset)
+    {
+        is_rewritten = true;
+        return false;
+    }
+    file.file_size = file_size;
+    file.file_mtime = file_mtime;
+
+    std::ifstream stream(file.fname, std::ios::binary);
+    if(!stream.is_open())
+        return false;
+
+    // The byte before the new data has to be the end of the last read line
+    const size_t first = file.offset > 0 ? file.offset - 1 : 0;
+    std::vector<char> buffer(file_size - first);
+    stream.seekg(first);
+    stream.read(buffer.data(), buffer.size());
+    buffer.resize(static_cast<size_t>(stream.gcount()));
+
+    if(file.offset > 0 && (buffer.empty() || buffer.front() != '\n'))
+    {
+        is_rewritten = true;
+        return false;
+    }
+    const size_t begin = file.offset - first;
+
+    // The last line might be not completely written yet, it is read next time
+    auto last_eol = std::find(buffer.rbegin(), buffer.rend(), '\n');
+    const size_t complete_size = buffer.rend() - last_eol;
+    if(complete_size <= begin)
+        return false;
+
+    Trajectory_parser::parse(
+        buffer.data() + begin,
+        buffer.data() + complete_size,
+        out,
+        file.columns);
+    file.offset += complete_size - begin;
+
+    return true;
 }
 
 //******************************************************************************
@@ -1,24 +1,369 @@
 #pragma once
 // local
+#include "Point_ranking.h"
+#include "Ring_buffer.h"
 #include "Scene_state.h"
+#include "Stream_receiver.h"
+#include "Trajectory_buffer.h"
+#include "Trajectory_parser.h"
 // std
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <map>
 #include <memory>
+#include <mutex>
 
 class Scene
 {
 public:
     Scene(std::shared_ptr<Scene_state> state);
+    ~Scene();
+
+    // Loads the files and replaces the curves of the scene state
     void load_ode(
         const std::vector<std::string>& fnames,
         float cuve_min_rad,
         float tesseract_size = 200.f);
 
+    // Starts loading of the files on a background thread, the current loading
+    // is canceled. The scene state is not changed until finish_loading()
+    void load_ode_async(
+        const std::vector<std::string>& fnames,
+        float cuve_min_rad,
+        float tesseract_size = 200.f);
+    // Loads the trajectories from the memory instead of the files, nothing is
+    // written to the disk. The buffers are kept to be loaded again by
+    // reload_ode_async(), so a view has to stay valid until the next loading
+    void load_ode(
+        const std::vector<Trajectory_buffer>& buffers,
+        float cuve_min_rad,
+        float tesseract_size = 200.f);
+    void load_ode_async(
+        const std::vector<Trajectory_buffer>& buffers,
+        float cuve_min_rad,
+        float tesseract_size = 200.f);
+    // Loads the last loaded files or buffers again, e.g. with other columns
+    void reload_ode_async(float cuve_min_rad, float tesseract_size = 200.f);
+
+    // The columns of the files loaded as the time and x, y, z, w. Applied to
+    // the next loading. Returns false and keeps the previous columns if one of
+    // them is No_column
+    bool set_columns(const Trajectory_parser::Columns& columns);
+    const Trajectory_parser::Columns& columns() const;
+    // The column with the trajectory id of ensemble files, which hold many
+    // trajectories each. No_column loads every file as one trajectory
+    void set_id_column(size_t column);
+    size_t id_column() const;
+    // Restricts the next loadings to the points with the time in
+    // [t_begin, t_end]. Only the window is parsed if the file is indexed or
+    // cached, and the timeline shows a coarse overview of the whole trajectory
+    void set_time_window(float t_begin, float t_end);
+    void clear_time_window();
+    bool has_time_window() const;
+    bool is_loading() const;
+    // Returns the approximate progress of the loading in the range [0, 1]
+    float loading_progress() const;
+    // Requests the loading to stop, it stops at the next check point
+    void cancel_loading();
+    bool is_loading_canceled() const;
+    // Moves the loaded curves to the scene state if the loading is finished.
+    // Huge files are shown as a decimated preview first, the preview is
+    // replaced by the full resolution curves later. Has to be called between
+    // frames. Returns true if the scene is replaced
+    bool finish_loading();
+
+    // Recomputes the switch detection of the curves with the thresholds of the
+    // scene state on a background thread, a running preview is canceled. The
+    // window extrema of the curves are kept, so a change of the thresholds
+    // alone is fast. The curves are not changed until finish_stats_preview()
+    void preview_stats();
+    bool is_previewing_stats() const;
+    // Replaces the statistics of the curves if the preview is finished. Has to
+    // be called between frames. Returns true if the curves are updated
+    bool finish_stats_preview();
+
+    // Simplifies the loaded curves again with the tolerance on a background
+    // thread, the running simplification is canceled. The points of the
+    // curves are ranked when the curves are loaded, so the simplification is
+    // a threshold over the ranking. The curves are not changed until
+    // finish_simplification()
+    void simplify_curves(float max_deviation);
+    bool is_simplifying() const;
+    // Replaces the curves by the simplified ones if the simplification is
+    // finished. Has to be called between frames. Returns true if the curves
+    // are replaced
+    bool finish_simplification();
+
+    // Reads the data appended to the loaded files since the last read (e.g. by
+    // a solver that is still running) and adds the new points to the curves.
+    // A file that is truncated or rewritten is loaded again. Returns true if
+    // any curve was updated
+    bool update_followed_files();
+
+    // Listens to the address for a solver that streams its points (see
+    // Stream_receiver) and shows them as a curve instead of the loaded ones.
+    // The curve holds the last `max_points` points and, if `max_duration` is
+    // positive, only the points of the last `max_duration` time units. Returns
+    // false if the address cannot be listened to
+    bool start_stream(
+        const std::string& address,
+        size_t max_points,
+        float max_duration = 0.f,
+        float tesseract_size = 200.f);
+    void stop_stream();
+    bool is_streaming() const;
+    bool is_stream_connected() const;
+    // Adds the received points to the stream curve and drops the points that
+    // left the window. Has to be called between frames. Returns true if the
+    // curve is updated
+    bool update_stream();
+
 private:
-    std::shared_ptr<Curve> load_curve(std::string fname);
+    // A loaded curve at the full resolution with the ranking of its points,
+    // the curve of the scene is simplified from it
+    struct Source_curve
+    {
+        std::shared_ptr<Curve> curve;
+        Point_ranking ranking;
+    };
+
+    // A loaded file that is watched for the appended data
+    struct Followed_file
+    {
+        std::string fname;
+        size_t offset; // Number of bytes that are already loaded
+        // Size and modification time of the file at the last read, see
+        // Trajectory_cache::get_source_stamp
+        uint64_t file_size;
+        int64_t file_mtime;
+        Trajectory_parser::Columns columns;
+        // The appended points are compacted the same way as the loaded ones,
+        // in the units of the loaded data
+        float stationary_epsilon;
+        std::array<float, 4> extent;
+        std::shared_ptr<Curve> curve;
+        std::shared_ptr<Source_curve> source;
+    };
+
+    // Parsed columns of a loaded file. Loading the file with other columns
+    // takes the known columns from here instead of parsing the file again.
+    // The columns of all the files together take at most
+    // Max_file_columns_size bytes, the columns of a file that do not fit are
+    // not kept
+    static constexpr size_t Max_file_columns_size = 256 << 20;
+    struct File_columns
+    {
+        // Size and modification time of the file when it was parsed, see
+        // Trajectory_cache::get_source_stamp
+        uint64_t file_size = 0;
+        int64_t file_mtime = 0;
+        size_t parsed_size = 0; // Size of the complete lines
+        size_t num_rows = 0;
+        std::map<size_t, std::shared_ptr<const std::vector<float>>> columns;
+    };
+
+    // The points of a live stream. The raw points of the window are kept in a
+    // ring buffer, the curve is extended by the new points and is rebuilt
+    // from the ring buffer once enough points have left the window
+    struct Stream
+    {
+        std::unique_ptr<Stream_receiver> receiver;
+        Ring_buffer<Stream_point> window;
+        float max_duration;
+        float tesseract_size;
+        // Points that left the window since the curve was rebuilt
+        size_t num_dropped = 0;
+
+        std::shared_ptr<Curve> curve;
+        // The boundaries the curve is normalized to, with a margin
+        std::array<float, 4> origin = {}, size = {};
+        Scene_vertex_t translate, scale;
+    };
+
+    // The result of a loading job
+    struct Loaded_scene
+    {
+        std::vector<std::shared_ptr<Curve>> curves;
+        std::vector<std::shared_ptr<Source_curve>> source_curves;
+        std::shared_ptr<Curve> overview_curve;
+        std::vector<Followed_file> followed_files;
+        std::array<float, 4> tesseract_size;
+        Scene_vertex_t translate, scale;
+    };
+
+    // The settings are copied from the scene state when the loading starts, so
+    // the job does not access the state while it is rendered
+    struct Loading_job
+    {
+        std::vector<std::string> fnames;
+        std::vector<Trajectory_buffer> buffers; // Loaded instead of the files
+        Trajectory_parser::Columns columns;
+        size_t id_column;
+        bool has_time_window;
+        float t_begin, t_end;
+        float cuve_min_rad;
+        float tesseract_size;
+        bool scale_tesseract;
+        float stationary_epsilon;
+        bool quantize_curves;
+        float stat_kernel_size,
+              stat_max_movement,
+              stat_max_value;
+
+        size_t total_bytes = 0;
+        Trajectory_parser::Progress progress;
+        std::atomic<size_t> num_processed_curves{0};
+        std::atomic<size_t> num_curves{0};
+
+        std::mutex preview_mutex;
+        std::unique_ptr<Loaded_scene> preview;
+
+        std::future<std::unique_ptr<Loaded_scene>> result;
+    };
+
+    // The switch detection of a preview, the thresholds are copied from the
+    // scene state when the preview starts
+    struct Stats_job
+    {
+        std::vector<std::shared_ptr<Curve>> curves;
+        float kernel_size,
+              max_movement,
+              max_value;
+
+        std::vector<Curve::Stats_data> stats;
+        std::atomic<bool> is_canceled{false};
+        std::future<bool> result;
+    };
+
+    // Simplification of the source curves with another tolerance, the
+    // settings are copied from the scene state when the job starts
+    struct Simplification_job
+    {
+        std::vector<std::shared_ptr<Source_curve>> source_curves;
+        float max_deviation;
+        bool quantize_curves;
+        float stat_kernel_size,
+              stat_max_movement,
+              stat_max_value;
+
+        std::vector<std::shared_ptr<Curve>> curves;
+        std::atomic<bool> is_canceled{false};
+        std::future<bool> result;
+    };
+
+    void start_loading(
+        const std::vector<std::string>& fnames,
+        const std::vector<Trajectory_buffer>& buffers,
+        float cuve_min_rad,
+        float tesseract_size);
+    std::unique_ptr<Loaded_scene> run_loading(Loading_job& job);
+    std::unique_ptr<Loaded_scene> build_scene(
+        Loading_job& job,
+        std::vector<std::shared_ptr<Curve>>& curves,
+        const std::vector<Scene_vertex_t>& origins,
+        const std::vector<Scene_vertex_t>& sizes,
+        std::atomic<size_t>* num_processed_curves);
+    bool load_columns(
+        const std::string& fname,
+        const Trajectory_parser::Columns& columns,
+        Trajectory_data& out,
+        size_t& file_size,
+        Trajectory_parser::Progress* progress);
+    bool load_buffer(
+        const Trajectory_buffer& buffer,
+        const Trajectory_parser::Columns& columns,
+        size_t num_samples,
+        Trajectory_data& out,
+        Trajectory_parser::Progress* progress);
+    void load_ensemble(
+        Loading_job& job,
+        size_t source,
+        std::vector<std::shared_ptr<Curve>>& curves,
+        std::vector<Scene_vertex_t>& origins,
+        std::vector<Scene_vertex_t>& sizes);
+    bool load_window(
+        const std::string& fname,
+        const Loading_job& job,
+        Trajectory_data& out,
+        Trajectory_data& summary,
+        Trajectory_parser::Progress* progress);
+    static void cut_window(
+        const Trajectory_data& data,
+        float t_begin,
+        float t_end,
+        Trajectory_data& out,
+        Trajectory_data& summary);
+    std::shared_ptr<Curve> load_curve(
+        const std::string& fname,
+        const Trajectory_parser::Columns& columns,
+        float stationary_epsilon,
+        Scene_vertex_t& origin,
+        Scene_vertex_t& size,
+        size_t& file_size,
+        Trajectory_parser::Progress* progress = nullptr);
+    std::shared_ptr<Curve> create_curve(
+        Trajectory_data& data,
+        float stationary_epsilon,
+        Scene_vertex_t& origin,
+        Scene_vertex_t& size);
+    // The boundaries of the data as scene vertices, the same as
+    // Vertex_object::get_boundaries
+    static void get_boundaries(
+        const std::array<float, 4>& data_origin,
+        const std::array<float, 4>& data_extent,
+        Scene_vertex_t& origin,
+        Scene_vertex_t& size);
+    bool run_stats_preview(Stats_job& job);
+    bool run_simplification(Simplification_job& job);
+    // Stops the running simplification, the source curves may be changed
+    // then. Returns true if a simplification was running
+    bool cancel_simplification();
+    // Stops the running preview, the curves may be changed then. Returns true
+    // if a preview was running
+    bool cancel_stats_preview();
+    bool read_appended_data(
+        Followed_file& file,
+        Trajectory_data& out,
+        bool& is_rewritten);
+    void rebuild_stream_curve();
     void normalize_curve(Curve& curve);
     void create_tesseract();
 
     std::shared_ptr<Scene_state> state_;
+
+    std::unique_ptr<Loading_job> loading_;
+
+    std::vector<std::string> fnames_;
+    std::vector<Trajectory_buffer> buffers_;
+    float tesseract_size_; // Of the last loading
+    Trajectory_parser::Columns columns_;
+    size_t id_column_;
+    bool has_time_window_;
+    float t_begin_, t_end_;
+
+    std::mutex file_columns_mutex_;
+    std::map<std::string, File_columns> file_columns_;
+
+    std::unique_ptr<Stats_job> stats_job_;
+    // Window extrema of the curves for the last previewed kernel size. The
+    // entry of a curve is dropped when points are added to the curve
+    std::map<
+        std::weak_ptr<const Curve>,
+        Curve::Window_extrema,
+        std::owner_less<std::weak_ptr<const Curve>>> window_extrema_;
+
+    // The curves of the scene are simplified from these, in the same order
+    std::vector<std::shared_ptr<Source_curve>> source_curves_;
+    std::unique_ptr<Simplification_job> simplification_;
+    float max_deviation_; // The tolerance of the last simplification
+
+    std::vector<Followed_file> followed_files_;
+    std::unique_ptr<Stream> stream_;
+    // The transformation applied to the loaded curves
+    Scene_vertex_t translate_, scale_;
+
     Scene_vertex_t c_origin;
     Scene_vertex_t c_size;
 };
@@ -74,9 +74,18 @@ void Scene_renderer::render()
         return;
     }
 
-    back_geometry_  = std::make_unique<Diffuse_shader::Mesh_geometry>();
-    front_geometry_ = std::make_unique<Diffuse_shader::Mesh_geometry>();
-    screen_geometry_ = std::make_unique<Screen_shader::Screen_geometry>();
+    // The geometry is kept from frame to frame to reuse its memory, the
+    // temporary objects of the previous frame are released all at once
+    if(!back_geometry_)
+    {
+        back_geometry_  = std::make_unique<Diffuse_shader::Mesh_geometry>();
+        front_geometry_ = std::make_unique<Diffuse_shader::Mesh_geometry>();
+        screen_geometry_ = std::make_unique<Screen_shader::Screen_geometry>();
+    }
+    back_geometry_->clear();
+    front_geometry_->clear();
+    screen_geometry_->clear();
+    frame_arena_.reset();
 
     label_points_.clear();
 
@@ -87,7 +96,7 @@ void Scene_renderer::render()
                static_cast<GLsizei>(display_scale_x_ * region_.width()),
                static_cast<GLsizei>(display_scale_y_ * region_.height()));
 
-    std::vector<float> anims =
+    std::pmr::vector<float> anims =
         split_animation(state_->unfolding_anim, number_of_animations_);
     float hide_4D = anims[0],
           project_curve_4D = anims[1],
@@ -141,25 +150,9 @@ void Scene_renderer::render()
     Scene_wireframe_object projected_t = *state_->tesseract.get();
     project_to_3D(projected_t.get_vertices(), rot_m);
 
-    // Choosing the high-resolution or the low-resolution curve
-    std::vector<Curve> projected_c;
-
-    // Array of curves used to project into 3D spaces
-    typedef std::vector<Curve> curves_3d_t;
-    std::vector<curves_3d_t> curves_3d;
-
-    for(size_t ci = 0; ci < state_->curves.size(); ++ci)
-    {
-        projected_c.push_back(*state_->curves[ci].get());
-    
-        curves_3d_t curves;
-        for(int i = 0; i < 8; ++i)
-            curves.push_back(*state_->curves[ci].get());
-        curves_3d.push_back(curves);
-
-        // Project curves from 4D to 3D
-        project_to_3D(projected_c[ci].get_vertices(), rot_m);
-    }
+    // The curves are only read, every view of a curve writes into its own
+    // array of points, the arrays keep their capacity from frame to frame
+    const size_t num_curves = state_->curves.size();
 
     // Animation unfolding the tesseract to the Dali-cross
     if(state_->unfolding_anim == 0)
@@ -171,24 +164,34 @@ void Scene_renderer::render()
         // Draw 4D curve
         if(state_->show_curve)
         {
-            for(size_t ci = 0; ci < projected_c.size(); ++ci)
+            projected_views_.resize(num_curves);
+            for(size_t ci = 0; ci < num_curves; ++ci)
             {
+                const Curve& curve = *state_->curves[ci];
+                auto& view = projected_views_[ci];
+
+                // Project curves from 4D to 3D
+                curve.decode_points(view);
+                project_to_3D(view, rot_m);
+
                 if(state_->use_unique_curve_colors)
                 {
                     draw_curve(
-                        projected_c[ci],
+                        curve,
+                        view,
                         1.,
                         state_->get_curve_color(ci));
                 }
                 else
                 {
                     draw_curve(
-                        projected_c[ci],
+                        curve,
+                        view,
                         1.,
                         state_->get_color(Curve_low_speed),
                         state_->get_color(Curve_high_speed));
                 }
-                draw_annotations(projected_c[ci], mvp_mat);
+                draw_annotations(curve, view, mvp_mat);
             }
         }
     }
@@ -196,11 +199,19 @@ void Scene_renderer::render()
     {
         std::vector<Cube> plots_3D = state_->tesseract->split();
 
-        for(auto& c: curves_3d)
-            move_curves_to_3D_plots(project_curve_4D, c);
+        // Copies of the curves moved to the 8 cubes
+        views_3D_.resize(num_curves);
+        for(size_t ci = 0; ci < num_curves; ++ci)
+        {
+            views_3D_[ci].resize(8);
+            for(auto& view : views_3D_[ci])
+                state_->curves[ci]->decode_points(view);
+
+            move_curves_to_3D_plots(project_curve_4D, views_3D_[ci]);
+        }
 
         if(unfold_4D > 0)
-            tesseract_unfolding(unfold_4D, plots_3D, curves_3d);
+            tesseract_unfolding(unfold_4D, plots_3D, views_3D_);
 
         // Project 3D plots from 4D to 3D
         auto rot = get_rotation_matrix(unfold_4D);
@@ -242,12 +253,13 @@ void Scene_renderer::render()
                 }
             }
 
-            for(size_t ci = 0; ci < curves_3d.size(); ++ci)
+            for(size_t ci = 0; ci < num_curves; ++ci)
             {
                 // Draw curves
                 if(state_->show_curve)
                 {
-                    for(size_t i = 0; i < curves_3d[ci].size(); ++i)
+                    const Curve& curve = *state_->curves[ci];
+                    for(size_t i = 0; i < views_3D_[ci].size(); ++i)
                     {
                         if(state_->use_simple_dali_cross && i != 1 &&
                            i != 2 && i != 5 && i != 7)
@@ -255,26 +267,29 @@ void Scene_renderer::render()
                             continue;
                         }
 
-                        auto c = curves_3d[ci][i];
-                        project_to_3D(c.get_vertices(), rot);
+                        // The cube views are still needed for the squares
+                        drawn_view_ = views_3D_[ci][i];
+                        project_to_3D(drawn_view_, rot);
 
                         if(state_->use_unique_curve_colors)
                         {
                             draw_curve(
-                                c,
+                                curve,
+                                drawn_view_,
                                 visibility_coeff(i) * (1.f - hide_3D),
                                 state_->get_curve_color(ci));
                         }
                         else
                         {
                             draw_curve(
-                                c,
+                                curve,
+                                drawn_view_,
                                 visibility_coeff(i) * (1.f - hide_3D),
                                 state_->get_color(Curve_low_speed),
                                 state_->get_color(Curve_high_speed));
                         }
                         if(visibility_coeff(i) == 1. && hide_3D < 0.5)
-                            draw_annotations(c, mvp_mat);
+                            draw_annotations(curve, drawn_view_, mvp_mat);
                     }
                 }
             }
@@ -286,31 +301,23 @@ void Scene_renderer::render()
             // Get the source plots
             std::vector<Square> plots_2D = Cube::split(plots_3D);
 
-            typedef std::vector<Curve> curvs_2d_t;
-            std::vector<curvs_2d_t> curves_2d;
+            // Copies of the cube views moved to the 6 squares
+            const size_t cube_of_square[] = {5, 1, 7, 1, 7, 7};
 
-            for(auto& c3d : curves_3d)
+            views_2D_.resize(num_curves);
+            for(size_t ci = 0; ci < num_curves; ++ci)
             {
-                std::vector<Curve> curves;
-                curves.push_back(c3d[5]);
-                curves.push_back(c3d[1]);
-                curves.push_back(c3d[7]);
-                curves.push_back(c3d[1]);
-                curves.push_back(c3d[7]);
-                curves.push_back(c3d[7]);
-
-                move_curves_to_2D_plots(project_curve_3D, curves);
-                curves_2d.push_back(curves);
-            }
+                auto& views = views_2D_[ci];
+                views.resize(6);
+                for(size_t i = 0; i < views.size(); ++i)
+                    views[i] = views_3D_[ci][cube_of_square[i]];
 
-            for(auto& c2d : curves_2d)
-            {
-                for(auto& c : c2d)
-                {
-                    project_to_3D(c.get_vertices(), rot);
-                }
+                move_curves_to_2D_plots(project_curve_3D, views);
+
+                for(auto& view : views)
+                    project_to_3D(view, rot);
             }
-            plots_unfolding(unfold_3D, plots_2D, curves_2d);
+            plots_unfolding(unfold_3D, plots_2D, views_2D_);
 
             // Draw 2D plots
             if(state_->show_tesseract)
@@ -326,24 +333,30 @@ void Scene_renderer::render()
             // Draw 2D curves
             if(state_->show_curve)
             {
-                for(size_t ci = 0; ci < curves_2d.size(); ++ci)
+                for(size_t ci = 0; ci < num_curves; ++ci)
                 {
-                    for(auto& c : curves_2d[ci])
+                    const Curve& curve = *state_->curves[ci];
+                    for(auto& view : views_2D_[ci])
                     {
                         if(state_->use_unique_curve_colors)
                         {
-                            draw_curve(c, 1., state_->get_curve_color(ci));
+                            draw_curve(
+                                curve,
+                                view,
+                                1.,
+                                state_->get_curve_color(ci));
                         }
                         else
                         {
                             draw_curve(
-                                c,
+                                curve,
+                                view,
                                 1.,
                                 state_->get_color(Curve_low_speed),
                                 state_->get_color(Curve_high_speed));
                         }
 
-                        draw_annotations(c, mvp_mat);
+                        draw_annotations(curve, view, mvp_mat);
                     }
                 }
             }
@@ -515,6 +528,29 @@ void Scene_renderer::project_to_3D(
     std::for_each(verts.begin(), verts.end(), project);
 }
 
+//******************************************************************************
+// project_to_3D
+//
+// Same as the projection of single vertices, done column by column
+//******************************************************************************
+
+void Scene_renderer::project_to_3D(
+    Point_store& points,
+    const boost::numeric::ublas::matrix<float>& rot_mat)
+{
+    points.transform(rot_mat);
+    points.translate(-state_->camera_4D);
+    points.transform(state_->projection_4D);
+
+    auto h = points.coord(4);
+    for(size_t k = 0; k < 3; ++k)
+    {
+        auto c = points.coord(k);
+        for(size_t i = 0; i < c.size(); ++i)
+            c[i] /= h[i];
+    }
+}
+
 namespace
 {
 //******************************************************************************
@@ -533,7 +569,7 @@ glm::vec4 ColorToGlm(const Color& c, const float alpha)
 
 void Scene_renderer::draw_tesseract(Scene_wireframe_object& t)
 {
-    Mesh t_mesh;
+    Mesh t_mesh(&frame_arena_);
     for(auto const& e : t.edges())
     {
         auto& current = t.get_vertices()[e.vert1];
@@ -584,17 +620,25 @@ void Scene_renderer::draw_tesseract(Scene_wireframe_object& t)
 // draw_curve
 //******************************************************************************
 
-void Scene_renderer::draw_curve(Curve& c, float opacity, const Color& color)
+void Scene_renderer::draw_curve(
+    const Curve& c,
+    const Point_store& view,
+    float opacity,
+    const Color& color)
 {
-    draw_curve(c, opacity, color, color);
+    draw_curve(c, view, opacity, color, color);
 }
 
 //******************************************************************************
 // draw_curve
+//
+// The view holds the transformed points of the curve, the curve itself gives
+// the time stamps and the statistics
 //******************************************************************************
 
 void Scene_renderer::draw_curve(
-    Curve& c,
+    const Curve& c,
+    const Point_store& view,
     float opacity,
     const Color& slow_c,
     const Color& fast_c)
@@ -618,43 +662,40 @@ void Scene_renderer::draw_curve(
                 opacity);
         };
 
+    const auto& points = view;
+    const auto x = points.coord(0), y = points.coord(1), z = points.coord(2),
+               w = points.coord(3);
+    auto position = [&x, &y, &z](size_t i) {
+        return glm::vec3(x[i], y[i], z[i]);
+    };
+
     // Curve
-    Mesh curve_mesh;
-    std::vector<glm::vec3> point_directions(c.vertices().size());
+    Mesh curve_mesh(&frame_arena_);
+    std::pmr::vector<glm::vec3> point_directions(
+        points.size(),
+        &frame_arena_);
     { // first
-        const auto& a = c.get_vertices()[0];
-        const auto& b = c.get_vertices()[1];
-        point_directions.front() = glm::normalize(
-            glm::vec3(b[0], b[1], b[2]) - glm::vec3(a[0], a[1], a[2]));
+        point_directions.front() =
+            glm::normalize(position(1) - position(0));
     }
-    for(size_t i = 1; i < c.vertices().size() - 1; ++i)
+    for(size_t i = 1; i < points.size() - 1; ++i)
     {
-        const auto& p1 = c.vertices()[i - 1];
-        const auto& p2 = c.vertices()[i];
-        const auto& p3 = c.vertices()[i + 1];
-        const glm::vec3 dir1 = glm::normalize(
-            glm::vec3(p2[0], p2[1], p2[2]) - glm::vec3(p1[0], p1[1], p1[2]));
-        const glm::vec3 dir2 = glm::normalize(
-            glm::vec3(p3[0], p3[1], p3[2]) - glm::vec3(p2[0], p2[1], p2[2]));
+        const glm::vec3 dir1 = glm::normalize(position(i) - position(i - 1));
+        const glm::vec3 dir2 = glm::normalize(position(i + 1) - position(i));
         point_directions[i] = glm::normalize(dir1 + dir2);
     }
     { // last
-        const auto& a = c.vertices()[c.vertices().size() - 2];
-        const auto& b = c.vertices()[c.vertices().size() - 1];
-        point_directions.back() = glm::normalize(
-            glm::vec3(b[0], b[1], b[2]) - glm::vec3(a[0], a[1], a[2]));
+        const size_t last = points.size() - 1;
+        point_directions.back() =
+            glm::normalize(position(last) - position(last - 1));
     }
 
-    for(size_t i = 0; i < c.edges().size(); ++i)
+    const auto time_stamp = view.time();
+    for(size_t i = 0; i < c.num_segments(); ++i)
     {
-        const auto& e = c.edges()[i];
-
-        auto& current = c.get_vertices()[e.vert1];
-        auto& next = c.get_vertices()[e.vert2];
-
         // We are interested only in some interval of the curve
         if(state_->curve_selection &&
-           !state_->curve_selection->in_range(c.time_stamp()[e.vert1]))
+           !state_->curve_selection->in_range(time_stamp[i]))
         {
             continue;
         }
@@ -665,10 +706,10 @@ void Scene_renderer::draw_curve(
 
         Mesh_generator::cylinder_v2(
             5,
-            curve_thickness_ / current(3),
-            curve_thickness_ / next(3),
-            glm::vec3(current(0), current(1), current(2)),
-            glm::vec3(next(0), next(1), next(2)),
+            curve_thickness_ / w[i],
+            curve_thickness_ / w[i + 1],
+            position(i),
+            position(i + 1),
             point_directions[i],
             point_directions[i + 1],
             get_speed_color(speed_coeff),
@@ -684,10 +725,11 @@ void Scene_renderer::draw_curve(
 
     if(state_->is_timeplayer_active)
     {
-        auto marker =
-            c.get_point(c.t_min() + state_->timeplayer_pos * c.t_duration());
+        auto marker = c.get_point(
+            c.t_min() + state_->timeplayer_pos * c.t_duration(),
+            view);
 
-        Mesh marker_mesh;
+        Mesh marker_mesh(&frame_arena_);
         Mesh_generator::sphere(
             5,
             5,
@@ -733,12 +775,12 @@ void Scene_renderer::set_fog(float fog_dist, float fog_range)
 // split_animation
 //******************************************************************************
 
-std::vector<float> Scene_renderer::split_animation(float animation,
-                                                   int    sections)
+std::pmr::vector<float> Scene_renderer::split_animation(float animation,
+                                                        int   sections)
 {
     float section_length = 1.f / sections;
 
-    std::vector<float> splited_animations(sections);
+    std::pmr::vector<float> splited_animations(sections, &frame_arena_);
 
     int current_section =
         animation == 1.f ? sections - 1 : (int)std::floor(animation * sections);
@@ -760,7 +802,10 @@ std::vector<float> Scene_renderer::split_animation(float animation,
 // draw_annotations
 //******************************************************************************
 
-void Scene_renderer::draw_annotations(Curve& c, const glm::mat4& projection)
+void Scene_renderer::draw_annotations(
+    const Curve& c,
+    const Point_store& view,
+    const glm::mat4& projection)
 {
     // Parameters
     const float min_arrow_dist(0.1f),
@@ -771,49 +816,46 @@ void Scene_renderer::draw_annotations(Curve& c, const glm::mat4& projection)
     const glm::vec4 arrow_color(0.f, 0.f, 0.f, 1.f),
                     sphere_color(0.f, 0.f, 0.f, 1.f);
 
-    auto annot_arrows = c.get_arrows(*state_->curve_selection.get());
-    auto annot_dots = c.get_markers(*state_->curve_selection.get());
+    c.get_arrows(*state_->curve_selection.get(), view, annot_arrows_);
+    c.get_markers(*state_->curve_selection.get(), view, annot_dots_);
 
-    // This variable points either to the filtered or original arrows
-    std::vector<Curve_annotations>* annot_ptr;
+    // The arrows to draw, either the filtered or all of them
+    std::pmr::vector<const Curve_annotations*> annot_ptrs(&frame_arena_);
+    annot_ptrs.reserve(annot_arrows_.size());
 
     // If necessary, filter the annotations
-    std::vector<Curve_annotations> filtered_annotations;
-    if(filter_arrow_annotations_)
+    for(size_t i = 0; i < annot_arrows_.size(); ++i)
     {
-        annot_ptr = &filtered_annotations;
+        auto& current = annot_arrows_[i];
+        double dist = std::numeric_limits<double>::max();
 
-        for(size_t i = 0; i < annot_arrows.size(); ++i)
+        for(size_t j = i + 1;
+            filter_arrow_annotations_ && j < annot_arrows_.size();
+            ++j)
         {
-            auto& current = annot_arrows[i];
-            double dist = std::numeric_limits<double>::max();
+            auto& next = annot_arrows_[j];
 
-            for(size_t j = i + 1; j < annot_arrows.size(); ++j)
+            double length = 0.;
+            for(char k = 0; k < 3; ++k)
             {
-                auto& next = annot_arrows[j];
-
-                auto v = next.point - current.point;
-                double length =
-                    std::sqrt(v(0) * v(0) + v(1) * v(1) + v(2) * v(2));
-
-                dist = std::min(length, dist);
+                const double d = next.point(k) - current.point(k);
+                length += d * d;
             }
+            length = std::sqrt(length);
 
-            if(dist > min_arrow_dist)
-            {
-                filtered_annotations.push_back(current);
-            }
+            dist = std::min(length, dist);
         }
-    }
-    else
-    {
-        annot_ptr = &annot_arrows;
+
+        if(dist > min_arrow_dist)
+            annot_ptrs.push_back(&current);
     }
 
     // Draw annotation points
 
-    for(auto& a : *annot_ptr)
+    for(auto a_ptr : annot_ptrs)
     {
+        auto& a = *a_ptr;
+
         // Copy and project point
 
         glm::vec4 point(a.point(0), a.point(1), a.point(2), 1.f);
@@ -841,7 +883,7 @@ void Scene_renderer::draw_annotations(Curve& c, const glm::mat4& projection)
             glm::vec4 right_side =
                 glm::rotateZ(dir, glm::radians(-30.f)) * size;     
 
-            Screen_shader::Line_strip line;
+            Screen_shader::Line_strip line(&frame_arena_);
             line.emplace_back(Screen_shader::Line_point(glm::vec2(pos.x -  left_side.x, pos.y -  left_side.y), 1.f, arrow_color));
             line.emplace_back(Screen_shader::Line_point(glm::vec2(pos.x,                pos.y               ), 1.f, arrow_color));
             line.emplace_back(Screen_shader::Line_point(glm::vec2(pos.x - right_side.x, pos.y - right_side.y), 1.f, arrow_color));
@@ -873,9 +915,9 @@ void Scene_renderer::draw_annotations(Curve& c, const glm::mat4& projection)
 
     // Draw switch points
 
-    for(auto& a : annot_dots)
+    for(auto& a : annot_dots_)
     {
-        Mesh mesh;
+        Mesh mesh(&frame_arena_);
         Mesh_generator::sphere(
             5,
             5,
@@ -959,37 +1001,45 @@ void Scene_renderer::draw_legend(const Region& region)
         color_to_vec4(state_->get_color(W_axis)));
 }
 
+namespace
+{
+//******************************************************************************
+// move_coord
+//
+// Moves the coordinate of every point of the view towards the target
+//******************************************************************************
+
+void move_coord(Point_store& view, size_t coord, float coeff, float target)
+{
+    for(auto& v : view.coord(coord))
+        v = v + coeff * (target - v);
+}
+} // namespace
+
 //******************************************************************************
 // move_curves_to_3D_plots
 //******************************************************************************
 
-void Scene_renderer::move_curves_to_3D_plots(float coeff,
-                                             std::vector<Curve>& curves)
+void Scene_renderer::move_curves_to_3D_plots(
+    float coeff,
+    std::vector<Point_store>& curves)
 {
     // Curve 1
-    for(auto& v : curves[0].get_vertices())
-        v(3) = v(3) + coeff * (state_->tesseract_size[3] / 2 - v(3));
+    move_coord(curves[0], 3, coeff, state_->tesseract_size[3] / 2);
     // Curve 2
-    for(auto& v : curves[1].get_vertices())
-        v(3) = v(3) + coeff * (-state_->tesseract_size[3] / 2 - v(3));
+    move_coord(curves[1], 3, coeff, -state_->tesseract_size[3] / 2);
     // Curve 3
-    for(auto& v : curves[2].get_vertices())
-        v(2) = v(2) + coeff * (state_->tesseract_size[2] / 2 - v(2));
+    move_coord(curves[2], 2, coeff, state_->tesseract_size[2] / 2);
     // Curve 4
-    for(auto& v : curves[3].get_vertices())
-        v(2) = v(2) + coeff * (-state_->tesseract_size[2] / 2 - v(2));
+    move_coord(curves[3], 2, coeff, -state_->tesseract_size[2] / 2);
     // Curve 5
-    for(auto& v : curves[4].get_vertices())
-        v(1) = v(1) + coeff * (-state_->tesseract_size[1] / 2 - v(1));
+    move_coord(curves[4], 1, coeff, -state_->tesseract_size[1] / 2);
     // Curve 6
-    for(auto& v : curves[5].get_vertices())
-        v(1) = v(1) + coeff * (state_->tesseract_size[1] / 2 - v(1));
+    move_coord(curves[5], 1, coeff, state_->tesseract_size[1] / 2);
     // Curve 7
-    for(auto& v : curves[6].get_vertices())
-        v(0) = v(0) + coeff * (-state_->tesseract_size[0] / 2 - v(0));
+    move_coord(curves[6], 0, coeff, -state_->tesseract_size[0] / 2);
     // Curve 8
-    for(auto& v : curves[7].get_vertices())
-        v(0) = v(0) + coeff * (state_->tesseract_size[0] / 2 - v(0));
+    move_coord(curves[7], 0, coeff, state_->tesseract_size[0] / 2);
 }
 
 //******************************************************************************
@@ -998,27 +1048,24 @@ void Scene_renderer::move_curves_to_3D_plots(float coeff,
 
 void Scene_renderer::move_curves_to_2D_plots(
     float coeff,
-    std::vector<Curve>& curves)
+    std::vector<Point_store>& curves)
 {
     // Curve 1
-    for(auto& v : curves[0].get_vertices())
-        v(2) = v(2) + coeff * (-state_->tesseract_size[2] / 2 - v(2));
+    move_coord(curves[0], 2, coeff, -state_->tesseract_size[2] / 2);
     // Curve 2
-    for(auto& v : curves[1].get_vertices())
-        v(2) = v(2) + coeff * (-state_->tesseract_size[2] / 2 - v(2));
+    move_coord(curves[1], 2, coeff, -state_->tesseract_size[2] / 2);
     // Curve 3
-    for(auto& v : curves[2].get_vertices())
-        v(2) = v(2) + coeff * (-state_->tesseract_size[2] / 2 - v(2));
+    move_coord(curves[2], 2, coeff, -state_->tesseract_size[2] / 2);
     // Curve 4
-    for(auto& v : curves[3].get_vertices())
-        v(1) = v(1) + coeff * (-state_->tesseract_size[1] / 2 - v(1));
+    move_coord(curves[3], 1, coeff, -state_->tesseract_size[1] / 2);
     // Curve 5
-    for(auto& v : curves[4].get_vertices())
-        v(1) = v(1) + coeff * (-state_->tesseract_size[1] / 2 - v(1));
+    move_coord(curves[4], 1, coeff, -state_->tesseract_size[1] / 2);
     // Curve 6
-    for(auto& v : curves[5].get_vertices())
-        v(0) = v(0) + coeff *
-        (0.5f * state_->tesseract_size[0] + state_->tesseract_size[3] - v(0));
+    move_coord(
+        curves[5],
+        0,
+        coeff,
+        0.5f * state_->tesseract_size[0] + state_->tesseract_size[3]);
 }
 
 //******************************************************************************
@@ -1028,7 +1075,7 @@ void Scene_renderer::move_curves_to_2D_plots(
 void Scene_renderer::tesseract_unfolding(
     float coeff,
     std::vector<Cube>& plots_3D,
-    std::vector<std::vector<Curve>>& curves_3D)
+    std::vector<std::vector<Point_store>>& curves_3D)
 {
     auto transform_3D_plot =
         [](Scene_wireframe_object& c,
@@ -1046,6 +1093,15 @@ void Scene_renderer::tesseract_unfolding(
                 v(i) -= disp(i);
         }
     };
+    auto transform_curve =
+        [](Point_store& points,
+           boost::numeric::ublas::matrix<float>& rot,
+           Scene_vertex_t disp)
+    {
+        points.translate(disp);
+        points.transform(rot);
+        points.translate(-disp);
+    };
 
     // Cube and curve 1 and 5
     {
@@ -1069,10 +1125,10 @@ void Scene_renderer::tesseract_unfolding(
 
         for(auto& c: curves_3D)
         {
-            transform_3D_plot(c[4], rot, disp1);
+            transform_curve(c[4], rot, disp1);
 
-            transform_3D_plot(c[0], rot, disp1);
-            transform_3D_plot(c[0], rot, disp2);
+            transform_curve(c[0], rot, disp1);
+            transform_curve(c[0], rot, disp2);
         }
     }
     // Cube and curve 3
@@ -1089,7 +1145,7 @@ void Scene_renderer::tesseract_unfolding(
         transform_3D_plot(plots_3D[2], rot, disp);
         
         for(auto& c: curves_3D)
-            transform_3D_plot(c[2], rot, disp);
+            transform_curve(c[2], rot, disp);
     }
     // Cube and curve 4
     {
@@ -1105,7 +1161,7 @@ void Scene_renderer::tesseract_unfolding(
         transform_3D_plot(plots_3D[3], rot, disp);
 
         for(auto& c: curves_3D)
-            transform_3D_plot(c[3], rot, disp);
+            transform_curve(c[3], rot, disp);
     }
     // Cube and curve 6
     {
@@ -1121,7 +1177,7 @@ void Scene_renderer::tesseract_unfolding(
         transform_3D_plot(plots_3D[5], rot, disp);
 
         for(auto& c: curves_3D)
-            transform_3D_plot(c[5], rot, disp);
+            transform_curve(c[5], rot, disp);
     }
     // Cube and curve 7
     {
@@ -1137,7 +1193,7 @@ void Scene_renderer::tesseract_unfolding(
         transform_3D_plot(plots_3D[6], rot, disp);
 
         for(auto& c: curves_3D)
-            transform_3D_plot(c[6], rot, disp);
+            transform_curve(c[6], rot, disp);
     }
     // Cube and curve 8
     {
@@ -1153,7 +1209,7 @@ void Scene_renderer::tesseract_unfolding(
         transform_3D_plot(plots_3D[7], rot, disp);
 
         for(auto& c: curves_3D)
-            transform_3D_plot(c[7], rot, disp);
+            transform_curve(c[7], rot, disp);
     }
 }
 
@@ -1207,7 +1263,7 @@ void Scene_renderer::draw_3D_plot(Cube& cube, float opacity)
     {
         auto const& e = cube.edges()[i];
 
-        Mesh t_mesh;
+        Mesh t_mesh(&frame_arena_);
 
         auto& current = cube.get_vertices()[e.vert1];
         auto& next = cube.get_vertices()[e.vert2];
@@ -1237,7 +1293,7 @@ void Scene_renderer::draw_2D_plot(Scene_wireframe_object& plot)
 {
     for(auto const& e : plot.edges())
     {
-        Mesh t_mesh;
+        Mesh t_mesh(&frame_arena_);
 
         auto& current = plot.get_vertices()[e.vert1];
         auto& next = plot.get_vertices()[e.vert2];
@@ -1263,7 +1319,7 @@ void Scene_renderer::draw_2D_plot(Scene_wireframe_object& plot)
 void Scene_renderer::plots_unfolding(
     float coeff,
     std::vector<Square>& plots_2D,
-    std::vector<std::vector<Curve>>& curves_2D)
+    std::vector<std::vector<Point_store>>& curves_2D)
 {
     auto transform_3D_plot =
         [](Scene_wireframe_object& c,
@@ -1288,6 +1344,19 @@ void Scene_renderer::plots_unfolding(
             v <<= copy_v(0), copy_v(1), copy_v(2), copy_v(3), 0;
         }
     };
+    auto transform_curve =
+        [](Point_store& points,
+           boost::numeric::ublas::matrix<float>& rot,
+           Scene_vertex_t& disp)
+    {
+        // The 4x4 matrix rotates only x, y, z, w
+        points.translate(disp);
+        points.transform(rot);
+        points.translate(-disp);
+
+        auto h = points.coord(4);
+        std::fill(h.begin(), h.end(), 0.f);
+    };
 
     {
         auto anchor = plots_2D[1].get_vertices()[0];
@@ -1307,9 +1376,9 @@ void Scene_renderer::plots_unfolding(
 
         for(auto& c: curves_2D)
         {
-            transform_3D_plot(c[3], rot, disp);
-            transform_3D_plot(c[4], rot, disp);
-            transform_3D_plot(c[5], rot, disp);
+            transform_curve(c[3], rot, disp);
+            transform_curve(c[4], rot, disp);
+            transform_curve(c[5], rot, disp);
         }
     }
     {
@@ -1327,7 +1396,7 @@ void Scene_renderer::plots_unfolding(
         transform_3D_plot(plots_2D[5], rot, disp);
 
         for(auto& c: curves_2D)
-            transform_3D_plot(c[5], rot, disp);
+            transform_curve(c[5], rot, disp);
     }
 }
 
@@ -1365,7 +1434,7 @@ void Scene_renderer::draw_labels_in_2D(const glm::mat4& projection)
     bottom_left = bottom_left * scale + disp;
     bottom_right = bottom_right * scale + disp;
 
-    std::vector<glm::vec4> points;
+    std::pmr::vector<glm::vec4> points(&frame_arena_);
     auto horiz_dir = bottom_right - bottom_left;
 
     auto lenght = glm::length(horiz_dir);
@@ -3,7 +3,10 @@
 #include "Base_renderer.h"
 #include "Scene_state.h"
 #include "Mesh.h"
+#include "Point_store.h"
+#include "Curve_annotations.h"
 #include "Diffuse_shader.h"
+#include "Frame_arena.h"
 #include "Screen_shader.h"
 #include "Scene_wireframe_object.h"
 #include "Text_renderer.h"
@@ -38,23 +41,38 @@ private:
     void project_to_3D(
         std::vector<Scene_vertex_t>& verts,
         const boost::numeric::ublas::matrix<float>& rot_mat);
+    void project_to_3D(
+        Point_store& points,
+        const boost::numeric::ublas::matrix<float>& rot_mat);
 
     void draw_tesseract(Scene_wireframe_object& t);
-    void draw_curve(Curve& c, float opacity, const Color& color);
     void draw_curve(
-        Curve& c,
+        const Curve& c,
+        const Point_store& view,
+        float opacity,
+        const Color& color);
+    void draw_curve(
+        const Curve& c,
+        const Point_store& view,
         float opacity,
         const Color& slow_c,
         const Color& fast_c);
-    void draw_annotations(Curve& c, const glm::mat4& projection);
+    void draw_annotations(
+        const Curve& c,
+        const Point_store& view,
+        const glm::mat4& projection);
     void draw_legend(const Region& region);
 
-    void move_curves_to_3D_plots(float coeff, std::vector<Curve>& curves);
-    void move_curves_to_2D_plots(float coeff, std::vector<Curve>& curves);
+    void move_curves_to_3D_plots(
+        float coeff,
+        std::vector<Point_store>& curves);
+    void move_curves_to_2D_plots(
+        float coeff,
+        std::vector<Point_store>& curves);
     void tesseract_unfolding(
         float coeff,
         std::vector<Cube>& plots_3D,
-        std::vector<std::vector<Curve>>& curves_3D);
+        std::vector<std::vector<Point_store>>& curves_3D);
     boost::numeric::ublas::matrix<float> get_rotation_matrix();
     boost::numeric::ublas::matrix<float>
     get_rotation_matrix(float view_straightening);
@@ -63,10 +81,10 @@ private:
     void plots_unfolding(
         float coeff,
         std::vector<Square>& plots_2D,
-        std::vector<std::vector<Curve>>& curves_2D);
+        std::vector<std::vector<Point_store>>& curves_2D);
     void draw_labels_in_2D(const glm::mat4& projection);
 
-    std::vector<float> split_animation(float animation_pos, int sections);
+    std::pmr::vector<float> split_animation(float animation_pos, int sections);
 
     // Drawing parameters
     float tesseract_thickness_,
@@ -91,6 +109,19 @@ private:
 
     bool filter_arrow_annotations_;
 
+    // Temporary objects of the current frame
+    Frame_arena frame_arena_;
+
     std::vector<boost::numeric::ublas::vector<double>> label_points_;
     bool show_labels_;
+
+    // Views of the curves reused from frame to frame: the projected curves,
+    // their copies in the 8 cubes and the 6 squares, and the cube view that
+    // is being drawn
+    std::vector<Point_store> projected_views_;
+    std::vector<std::vector<Point_store>> views_3D_, views_2D_;
+    Point_store drawn_view_;
+    // Annotations of the drawn curve reused from frame to frame
+    std::vector<Curve_annotations> annot_arrows_;
+    std::vector<Scene_vertex_t> annot_dots_;
 };
@@ -32,6 +32,8 @@ Scene_state::Scene_state()
     , stat_kernel_size(0.01f)
     , stat_max_movement(0.01f)
     , stat_max_value(0.01f)
+    , stationary_epsilon(1e-5f)
+    , quantize_curves(false)
 {
     curve_colors_.emplace_back(Color(228,  26,  28));
     curve_colors_.emplace_back(Color( 55, 126, 184));
@@ -82,3 +84,15 @@ std::shared_ptr<Curve> Scene_state::selected_curve()
     else
         return curves.front();
 }
+
+//******************************************************************************
+// timeline_curve
+//******************************************************************************
+
+std::shared_ptr<Curve> Scene_state::timeline_curve()
+{
+    if(overview_curve)
+        return overview_curve;
+    else
+        return selected_curve();
+}
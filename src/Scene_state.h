@@ -34,6 +34,9 @@ public:
     void update_color(int color_id, const Color& color);
 
     std::shared_ptr<Curve> selected_curve();
+    // The curve drawn on the timeline: the overview of the whole trajectory if
+    // only a time window of it is loaded, otherwise the selected curve
+    std::shared_ptr<Curve> timeline_curve();
 
     glm::mat4 projection_3D;
     glm::quat rotation_3D;
@@ -46,6 +49,8 @@ public:
     float fov_y;
 
     std::vector<std::shared_ptr<Curve>> curves;
+    // Coarse curve of the whole trajectory, set if a time window is loaded
+    std::shared_ptr<Curve> overview_curve;
     std::shared_ptr<Curve_selection> curve_selection;
 
     std::shared_ptr<Tesseract> tesseract;
@@ -67,6 +72,13 @@ public:
           stat_max_movement,
           stat_max_value;
 
+    // Points closer to each other are compacted when a trajectory is loaded.
+    // Relative to the bounding box of the trajectory, zero keeps every point
+    float stationary_epsilon;
+
+    // The loaded curves are kept in the 16-bit storage, see Quantized_store
+    bool quantize_curves;
+
     std::array<float, 4> tesseract_size;
 
 private:
@@ -5,6 +5,7 @@
 #include "Geometry_engine.h"
 // std
 #include <memory>
+#include <memory_resource>
 #include <vector>
 // glm
 #include <glm/glm.hpp>
@@ -30,7 +31,8 @@ public:
         glm::float32 width;
         glm::vec4    color;
     };
-    typedef std::vector<Line_point> Line_strip;
+    // Strips built during a frame take the memory of the frame arena
+    typedef std::pmr::vector<Line_point> Line_strip;
 
     struct Rectangle
     {
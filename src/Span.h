@@ -0,0 +1,148 @@
+#pragma once
+// std
+#include <cassert>
+#include <cstddef>
+
+// Non-owning view of a contiguous array, a minimal replacement of std::span
+template<class T>
+class Span
+{
+public:
+    Span();
+    Span(T* data, size_t size);
+    // A span of mutable values is also a span of constant values
+    template<class U>
+    Span(const Span<U>& other);
+
+    T*     data() const;
+    size_t size() const;
+    bool   empty() const;
+
+    T& operator[](size_t i) const;
+    T& front() const;
+    T& back() const;
+
+    T* begin() const;
+    T* end() const;
+
+private:
+    T*     data_;
+    size_t size_;
+};
+
+//******************************************************************************
+// Span
+//******************************************************************************
+
+template<class T>
+Span<T>::Span()
+    : data_(nullptr)
+    , size_(0)
+{
+}
+
+//******************************************************************************
+// Span
+//******************************************************************************
+
+template<class T>
+Span<T>::Span(T* data, size_t size)
+    : data_(data)
+    , size_(size)
+{
+}
+
+//******************************************************************************
+// Span
+//******************************************************************************
+
+template<class T>
+template<class U>
+Span<T>::Span(const Span<U>& other)
+    : data_(other.data())
+    , size_(other.size())
+{
+}
+
+//******************************************************************************
+// data
+//******************************************************************************
+
+template<class T>
+T* Span<T>::data() const
+{
+    return data_;
+}
+
+//******************************************************************************
+// size
+//******************************************************************************
+
+template<class T>
+size_t Span<T>::size() const
+{
+    return size_;
+}
+
+//******************************************************************************
+// empty
+//******************************************************************************
+
+template<class T>
+bool Span<T>::empty() const
+{
+    return size_ == 0;
+}
+
+//******************************************************************************
+// operator[]
+//******************************************************************************
+
+template<class T>
+T& Span<T>::operator[](size_t i) const
+{
+    assert(i < size_);
+    return data_[i];
+}
+
+//******************************************************************************
+// front
+//******************************************************************************
+
+template<class T>
+T& Span<T>::front() const
+{
+    assert(size_ > 0);
+    return data_[0];
+}
+
+//******************************************************************************
+// back
+//******************************************************************************
+
+template<class T>
+T& Span<T>::back() const
+{
+    assert(size_ > 0);
+    return data_[size_ - 1];
+}
+
+//******************************************************************************
+// begin
+//******************************************************************************
+
+template<class T>
+T* Span<T>::begin() const
+{
+    return data_;
+}
+
+//******************************************************************************
+// end
+//******************************************************************************
+
+template<class T>
+T* Span<T>::end() const
+{
+    return data_ + size_;
+}
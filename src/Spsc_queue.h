@@ -0,0 +1,93 @@
+#pragma once
+// std
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Neither push() nor pop() blocks or allocates. The capacity is rounded
+// up to a power of two
+template<typename T>
+class Spsc_queue
+{
+public:
+    explicit Spsc_queue(size_t capacity);
+
+    Spsc_queue(const Spsc_queue&) = delete;
+    Spsc_queue& operator=(const Spsc_queue&) = delete;
+
+    // Called by the producer. Returns false if the queue is full
+    bool push(const T& value);
+    // Called by the consumer. Returns false if the queue is empty
+    bool pop(T& value);
+
+    size_t capacity() const;
+
+private:
+    std::vector<T> items_;
+    size_t mask_;
+
+    // The positions grow without wrapping. They are kept on separate cache
+    // lines, so the producer and the consumer do not invalidate each other
+    alignas(64) std::atomic<size_t> head_; // The next item to pop
+    alignas(64) std::atomic<size_t> tail_; // The next item to push
+};
+
+//******************************************************************************
+// Spsc_queue
+//******************************************************************************
+
+template<typename T>
+Spsc_queue<T>::Spsc_queue(size_t capacity)
+    : head_(0),
+      tail_(0)
+{
+    size_t size = 1;
+    while(size < capacity)
+        size *= 2;
+
+    items_.resize(size);
+    mask_ = size - 1;
+}
+
+//******************************************************************************
+// push
+//******************************************************************************
+
+template<typename T>
+bool Spsc_queue<T>::push(const T& value)
+{
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if(tail - head_.load(std::memory_order_acquire) == items_.size())
+        return false;
+
+    items_[tail & mask_] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+//******************************************************************************
+// pop
+//******************************************************************************
+
+template<typename T>
+bool Spsc_queue<T>::pop(T& value)
+{
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if(head == tail_.load(std::memory_order_acquire))
+        return false;
+
+    value = items_[head & mask_];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+//******************************************************************************
+// capacity
+//******************************************************************************
+
+template<typename T>
+size_t Spsc_queue<T>::capacity() const
+{
+    return items_.size();
+}
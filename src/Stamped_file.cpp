@@ -0,0 +1,108 @@
+#include "Stamped_file.h"
+// Local
+#include "Trajectory_cache.h"
+// std
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace
+{
+const uint32_t Byte_order = 0x01020304;
+} // namespace
+
+//******************************************************************************
+// make_stamp
+//******************************************************************************
+
+bool Stamped_file::make_stamp(
+    const char (&magic)[8],
+    uint32_t version,
+    const std::string& source_fname,
+    const Trajectory_parser::Columns& columns,
+    Stamp& out)
+{
+    std::memset(&out, 0, sizeof(Stamp));
+    std::memcpy(out.magic, magic, sizeof(out.magic));
+    out.version = version;
+    out.byte_order = Byte_order;
+    for(size_t i = 0; i < columns.size(); ++i)
+        out.columns[i] = columns[i];
+
+    return Trajectory_cache::get_source_stamp(
+        source_fname, out.source_size, out.source_mtime);
+}
+
+//******************************************************************************
+// is_valid
+//******************************************************************************
+
+bool Stamped_file::is_valid(
+    const Stamp& stamp,
+    const char (&magic)[8],
+    uint32_t version,
+    const std::string& source_fname,
+    const Trajectory_parser::Columns& columns)
+{
+    uint64_t source_size;
+    int64_t source_mtime;
+    if(!Trajectory_cache::get_source_stamp(
+            source_fname, source_size, source_mtime))
+    {
+        return false;
+    }
+
+    if(std::memcmp(stamp.magic, magic, sizeof(stamp.magic)) != 0 ||
+       stamp.version != version ||
+       stamp.byte_order != Byte_order ||
+       stamp.source_size != source_size ||
+       stamp.source_mtime != source_mtime)
+    {
+        return false;
+    }
+
+    for(size_t i = 0; i < columns.size(); ++i)
+    {
+        if(stamp.columns[i] != columns[i])
+            return false;
+    }
+
+    return true;
+}
+
+//******************************************************************************
+// write
+//******************************************************************************
+
+bool Stamped_file::write(
+    const std::string& fname,
+    const std::function<void(std::ostream&)>& write)
+{
+    const std::string tmp_fname = fname + ".tmp";
+    {
+        std::ofstream stream(tmp_fname, std::ios::binary | std::ios::trunc);
+        if(!stream.is_open())
+            return false;
+
+        write(stream);
+
+        if(!stream.good())
+        {
+            stream.close();
+            std::remove(tmp_fname.c_str());
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_fname, fname, ec);
+    if(ec)
+    {
+        std::filesystem::remove(tmp_fname, ec);
+        return false;
+    }
+
+    return true;
+}
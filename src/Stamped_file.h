@@ -0,0 +1,52 @@
+#pragma once
+// Local
+#include "Trajectory_parser.h"
+// std
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+
+// Files derived from a source trajectory file, such as Trajectory_cache and
+// Trajectory_index, start with a Stamp. The stamp keeps the size and the
+// modification time of the source file and the loaded columns, so a derived
+// file that is stale or made for other columns is detected and ignored
+namespace Stamped_file
+{
+struct Stamp
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t source_size;
+    int64_t  source_mtime;
+    uint64_t columns[5]; // Columns of the source file
+};
+static_assert(sizeof(Stamp) == 72, "The stamp must be 72 bytes");
+
+// Fills the stamp for the current version of the source file. Returns false
+// if the source file cannot be read
+bool make_stamp(
+    const char (&magic)[8],
+    uint32_t version,
+    const std::string& source_fname,
+    const Trajectory_parser::Columns& columns,
+    Stamp& out);
+
+// True if the stamp has the magic and the version, the byte order of this
+// machine and matches the current version of the source file and the columns
+bool is_valid(
+    const Stamp& stamp,
+    const char (&magic)[8],
+    uint32_t version,
+    const std::string& source_fname,
+    const Trajectory_parser::Columns& columns);
+
+// Writes the file with `write` to a temporary file first and renames it then,
+// so a partially written file is never picked up by another instance. Returns
+// false if the stream fails, the temporary file is removed then
+bool write(
+    const std::string& fname,
+    const std::function<void(std::ostream&)>& write);
+
+} // namespace Stamped_file
@@ -0,0 +1,346 @@
+#include "Stream_receiver.h"
+// std
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+// Platform
+#if defined(_WIN32)
+#include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+// The connection is checked for the stop request this often
+const int Poll_timeout_ms = 100;
+} // namespace
+
+//******************************************************************************
+// Stream_receiver
+//******************************************************************************
+
+Stream_receiver::Stream_receiver(
+    const std::string& address,
+    size_t queue_capacity/* = 1 << 16*/)
+    : address_(address),
+      queue_(queue_capacity),
+      is_first_point_(false),
+#ifdef _WIN32
+      pipe_(INVALID_HANDLE_VALUE),
+#else
+      socket_(-1),
+      socket_device_(0),
+      socket_inode_(0),
+#endif
+      is_open_(false),
+      is_connected_(false),
+      is_finished_(false),
+      stop_(false)
+{
+    is_open_ = open();
+    if(is_open_)
+        thread_ = std::thread(&Stream_receiver::receive_loop, this);
+}
+
+//******************************************************************************
+// ~Stream_receiver
+//******************************************************************************
+
+Stream_receiver::~Stream_receiver()
+{
+    stop_ = true;
+    if(thread_.joinable())
+    {
+#ifdef _WIN32
+        // The pipe is waited for in blocking calls, they are interrupted until
+        // the thread notices the stop request
+        while(!is_finished_)
+        {
+            CancelSynchronousIo(thread_.native_handle());
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+#endif
+        thread_.join();
+    }
+
+    close();
+}
+
+//******************************************************************************
+// default_address
+//******************************************************************************
+
+std::string Stream_receiver::default_address()
+{
+#ifdef _WIN32
+    return "\\\\.\\pipe\\manylands";
+#else
+    return "/tmp/manylands.sock";
+#endif
+}
+
+//******************************************************************************
+// is_open
+//******************************************************************************
+
+bool Stream_receiver::is_open() const
+{
+    return is_open_;
+}
+
+//******************************************************************************
+// is_connected
+//******************************************************************************
+
+bool Stream_receiver::is_connected() const
+{
+    return is_connected_;
+}
+
+//******************************************************************************
+// pop
+//******************************************************************************
+
+bool Stream_receiver::pop(Stream_point& point)
+{
+    return queue_.pop(point);
+}
+
+//******************************************************************************
+// open
+//******************************************************************************
+
+bool Stream_receiver::open()
+{
+#if defined(_WIN32)
+    pipe_ = CreateNamedPipeA(
+        address_.c_str(),
+        PIPE_ACCESS_INBOUND,
+        PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT,
+        1,
+        0,
+        1 << 16,
+        0,
+        nullptr);
+    return pipe_ != INVALID_HANDLE_VALUE;
+#elif defined(__EMSCRIPTEN__)
+    return false;
+#else
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if(address_.empty() || address_.size() >= sizeof(addr.sun_path))
+        return false;
+    std::memcpy(addr.sun_path, address_.c_str(), address_.size());
+
+    socket_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(socket_ < 0)
+        return false;
+
+    // A socket file left by a previous run would fail the binding. Any other
+    // file at the address is the user's, it is never removed
+    struct stat info;
+    if(lstat(address_.c_str(), &info) == 0)
+    {
+        if(!S_ISSOCK(info.st_mode) || unlink(address_.c_str()) != 0)
+        {
+            ::close(socket_);
+            socket_ = -1;
+            return false;
+        }
+    }
+    else if(errno != ENOENT)
+    {
+        ::close(socket_);
+        socket_ = -1;
+        return false;
+    }
+
+    if(bind(socket_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+       listen(socket_, 1) != 0 ||
+       lstat(address_.c_str(), &info) != 0)
+    {
+        ::close(socket_);
+        socket_ = -1;
+        return false;
+    }
+
+    // The file is removed on closing only if it is still the bound socket
+    socket_device_ = static_cast<uint64_t>(info.st_dev);
+    socket_inode_ = static_cast<uint64_t>(info.st_ino);
+    return true;
+#endif
+}
+
+//******************************************************************************
+// close
+//******************************************************************************
+
+void Stream_receiver::close()
+{
+#if defined(_WIN32)
+    if(pipe_ != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(pipe_);
+        pipe_ = INVALID_HANDLE_VALUE;
+    }
+#elif !defined(__EMSCRIPTEN__)
+    if(socket_ >= 0)
+    {
+        ::close(socket_);
+        socket_ = -1;
+
+        struct stat info;
+        if(lstat(address_.c_str(), &info) == 0 && S_ISSOCK(info.st_mode) &&
+           static_cast<uint64_t>(info.st_dev) == socket_device_ &&
+           static_cast<uint64_t>(info.st_ino) == socket_inode_)
+        {
+            unlink(address_.c_str());
+        }
+    }
+#endif
+}
+
+//******************************************************************************
+// receive_loop
+//
+// Waits for a solver to connect and reads its frames until it disconnects
+//******************************************************************************
+
+void Stream_receiver::receive_loop()
+{
+    std::vector<char> buffer(1 << 16);
+
+    while(!stop_)
+    {
+#if defined(_WIN32)
+        if(!ConnectNamedPipe(pipe_, nullptr) &&
+           GetLastError() != ERROR_PIPE_CONNECTED)
+        {
+            continue;
+        }
+
+        is_connected_ = true;
+        is_first_point_ = true;
+        pending_.clear();
+
+        while(!stop_)
+        {
+            DWORD size = 0;
+            if(!ReadFile(pipe_,
+                         buffer.data(),
+                         static_cast<DWORD>(buffer.size()),
+                         &size,
+                         nullptr) ||
+               size == 0 ||
+               !process_bytes(buffer.data(), size))
+            {
+                break;
+            }
+        }
+
+        DisconnectNamedPipe(pipe_);
+#elif !defined(__EMSCRIPTEN__)
+        pollfd listening = {socket_, POLLIN, 0};
+        if(poll(&listening, 1, Poll_timeout_ms) <= 0)
+            continue;
+
+        const int client = accept(socket_, nullptr, nullptr);
+        if(client < 0)
+            continue;
+
+        is_connected_ = true;
+        is_first_point_ = true;
+        pending_.clear();
+
+        while(!stop_)
+        {
+            pollfd connection = {client, POLLIN, 0};
+            const int res = poll(&connection, 1, Poll_timeout_ms);
+            if(res == 0)
+                continue;
+            if(res < 0)
+                break;
+
+            const ssize_t size = read(client, buffer.data(), buffer.size());
+            if(size <= 0 || !process_bytes(buffer.data(), size))
+                break;
+        }
+
+        ::close(client);
+#endif
+        is_connected_ = false;
+    }
+
+    is_finished_ = true;
+}
+
+//******************************************************************************
+// process_bytes
+//******************************************************************************
+
+bool Stream_receiver::process_bytes(const char* data, size_t size)
+{
+    pending_.insert(pending_.end(), data, data + size);
+
+    const size_t point_size = 5 * sizeof(float);
+    size_t pos = 0;
+    while(pending_.size() - pos >= sizeof(uint32_t))
+    {
+        uint32_t num_points;
+        std::memcpy(&num_points, pending_.data() + pos, sizeof(uint32_t));
+        if(num_points > Max_frame_points)
+            return false;
+
+        const size_t frame_size = sizeof(uint32_t) + num_points * point_size;
+        if(pending_.size() - pos < frame_size)
+            break;
+
+        const char* p = pending_.data() + pos + sizeof(uint32_t);
+        for(uint32_t i = 0; i < num_points; ++i, p += point_size)
+        {
+            float values[5];
+            std::memcpy(values, p, point_size);
+
+            Stream_point point;
+            point.t = values[0];
+            point.x = values[1];
+            point.y = values[2];
+            point.z = values[3];
+            point.w = values[4];
+            point.is_first = is_first_point_;
+            is_first_point_ = false;
+
+            if(!push_point(point))
+                return false;
+        }
+
+        pos += frame_size;
+    }
+
+    pending_.erase(pending_.begin(), pending_.begin() + pos);
+    return true;
+}
+
+//******************************************************************************
+// push_point
+//
+// Waits while the queue is full. Returns false if the receiver is stopped
+//******************************************************************************
+
+bool Stream_receiver::push_point(const Stream_point& point)
+{
+    while(!queue_.push(point))
+    {
+        if(stop_)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return true;
+}
@@ -0,0 +1,88 @@
+#pragma once
+// Local
+#include "Spsc_queue.h"
+// std
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A point received from a running solver
+struct Stream_point
+{
+    float t, x, y, z, w;
+    // The first point of a connection, the points received before belong to
+    // another run of the solver
+    bool is_first = false;
+};
+
+// Receiver of the points streamed by a solver over a local connection: a Unix
+// domain socket, or a named pipe on Windows (e.g. "\\.\pipe\manylands"). One
+// solver is connected at a time. The connection is served by a background
+// thread, which puts the points into a lock-free queue that the render thread
+// drains once per frame. If the queue is full, the reading is paused, so the
+// solver is slowed down instead of the points being lost.
+//
+// The solver writes frames, all values are little-endian:
+//
+//     uint32  number of the points N (at most Max_frame_points)
+//     float32 N points of five values each: t, x, y, z, w
+//
+// A malformed frame closes the connection. A file at the address that is not a
+// socket fails the opening, only sockets are replaced and removed. Not
+// available in the browser.
+class Stream_receiver
+{
+public:
+    static const uint32_t Max_frame_points = 1 << 20;
+
+    explicit Stream_receiver(
+        const std::string& address,
+        size_t queue_capacity = 1 << 16);
+    ~Stream_receiver();
+
+    Stream_receiver(const Stream_receiver&) = delete;
+    Stream_receiver& operator=(const Stream_receiver&) = delete;
+
+    // The address used if none is given, it depends on the platform
+    static std::string default_address();
+
+    // True if the address is listened to
+    bool is_open() const;
+    // True while a solver is connected
+    bool is_connected() const;
+
+    // Takes the next received point. Called by one (consumer) thread only
+    bool pop(Stream_point& point);
+
+private:
+    bool open();
+    void close();
+    void receive_loop();
+    // Splits the received bytes into frames. Returns false for a malformed
+    // frame
+    bool process_bytes(const char* data, size_t size);
+    bool push_point(const Stream_point& point);
+
+    std::string address_;
+    Spsc_queue<Stream_point> queue_;
+
+    // Bytes of an incomplete frame
+    std::vector<char> pending_;
+    bool is_first_point_;
+
+#ifdef _WIN32
+    void* pipe_; // HANDLE, the Windows header is not exposed
+#else
+    int socket_;
+    // Identity of the bound socket file
+    uint64_t socket_device_;
+    uint64_t socket_inode_;
+#endif
+    bool is_open_;
+    std::atomic<bool> is_connected_;
+    std::atomic<bool> is_finished_;
+    std::atomic<bool> stop_;
+    std::thread thread_;
+};
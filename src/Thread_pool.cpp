@@ -0,0 +1,164 @@
+#include "Thread_pool.h"
+// std
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+//******************************************************************************
+// Thread_pool
+//******************************************************************************
+
+Thread_pool::Thread_pool(size_t num_threads)
+    : stop_(false)
+{
+#ifndef __EMSCRIPTEN__
+    for(size_t i = 0; i < num_threads; ++i)
+        workers_.emplace_back(&Thread_pool::worker_loop, this);
+#endif
+}
+
+//******************************************************************************
+// ~Thread_pool
+//******************************************************************************
+
+Thread_pool::~Thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    condition_.notify_all();
+
+    for(auto& w : workers_)
+        w.join();
+}
+
+//******************************************************************************
+// global
+//******************************************************************************
+
+Thread_pool& Thread_pool::global()
+{
+    static Thread_pool pool(std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+}
+
+//******************************************************************************
+// size
+//******************************************************************************
+
+size_t Thread_pool::size() const
+{
+    return workers_.size();
+}
+
+//******************************************************************************
+// submit
+//******************************************************************************
+
+void Thread_pool::submit(std::function<void()> task)
+{
+    if(workers_.empty())
+    {
+        task();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    condition_.notify_one();
+}
+
+//******************************************************************************
+// parallel_for
+//******************************************************************************
+
+void Thread_pool::parallel_for(
+    size_t count,
+    const std::function<void(size_t)>& fn)
+{
+    if(count == 0)
+        return;
+
+    if(workers_.empty() || count == 1)
+    {
+        for(size_t i = 0; i < count; ++i)
+            fn(i);
+        return;
+    }
+
+    // The job state is shared with the helper tasks. Helpers that start after
+    // all the indices are taken only touch the job state and never `fn`
+    struct Job
+    {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::exception_ptr error;
+    };
+    auto job = std::make_shared<Job>();
+
+    auto run = [job, count, &fn]() {
+        size_t i;
+        while((i = job->next++) < count)
+        {
+            try
+            {
+                fn(i);
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                if(!job->error)
+                    job->error = std::current_exception();
+            }
+
+            if(++job->done == count)
+            {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                job->finished.notify_all();
+            }
+        }
+    };
+
+    const size_t num_helpers = std::min(count - 1, workers_.size());
+    for(size_t i = 0; i < num_helpers; ++i)
+        submit(run);
+
+    run();
+
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->finished.wait(lock, [&job, count]() { return job->done == count; });
+
+    if(job->error)
+        std::rethrow_exception(job->error);
+}
+
+//******************************************************************************
+// worker_loop
+//******************************************************************************
+
+void Thread_pool::worker_loop()
+{
+    while(true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(
+                lock, [this]() { return stop_ || !tasks_.empty(); });
+
+            if(stop_ && tasks_.empty())
+                return;
+
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        task();
+    }
+}
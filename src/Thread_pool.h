@@ -0,0 +1,44 @@
+#pragma once
+// std
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A simple pool of worker threads. The pool is used to run independent parts
+// of the data loading and processing in parallel. In builds without thread
+// support (Emscripten) the pool has no workers and all the work is executed by
+// the calling thread.
+class Thread_pool
+{
+public:
+    Thread_pool(size_t num_threads);
+    ~Thread_pool();
+
+    Thread_pool(const Thread_pool&) = delete;
+    Thread_pool& operator=(const Thread_pool&) = delete;
+
+    // The pool shared by the whole application, it has a worker per core
+    static Thread_pool& global();
+
+    size_t size() const;
+
+    // Schedules the task to be executed by one of the workers
+    void submit(std::function<void()> task);
+
+    // Calls fn(i) for every i in [0, count) and waits until all the calls are
+    // finished. The calling thread takes part in the work, so it is safe to
+    // call the function from a task that is executed by the pool
+    void parallel_for(size_t count, const std::function<void(size_t)>& fn);
+
+private:
+    void worker_loop();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stop_;
+};
@@ -64,7 +64,15 @@ void Timeline_renderer::render()
     if(!state_->selected_curve())
         return;
 
-    screen_geom_ = std::make_unique<Screen_shader::Screen_geometry>();
+    // The geometry is kept from frame to frame to reuse its memory, the
+    // temporary objects of the previous frame are released all at once
+    if(!screen_geom_)
+        screen_geom_ = std::make_unique<Screen_shader::Screen_geometry>();
+    screen_geom_->clear();
+    frame_arena_.reset();
+
+    // The points of the selected curve are decoded once for the whole frame
+    selected_points_ = &state_->selected_curve()->points(selected_buffer_);
 
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -86,7 +94,7 @@ void Timeline_renderer::render()
                        GL_FALSE,
                        glm::value_ptr(proj_ortho));
 
-    std::vector<Compas_state> pos_and_scale =
+    std::pmr::vector<Compas_state> pos_and_scale =
         get_compases_state(pictogram_region_);
 
     // On-screen rendering
@@ -151,7 +159,7 @@ void Timeline_renderer::process_input(const Renderer_io& io)
 
     if(pictogram_mouse_down)
     {
-        std::vector<Compas_state> pos_and_scale =
+        std::pmr::vector<Compas_state> pos_and_scale =
             get_compases_state(pictogram_region_);
 
         size_t pictog_ind = 0;
@@ -167,41 +175,29 @@ void Timeline_renderer::process_input(const Renderer_io& io)
             }
         }
 
-        std::string view;
-        if(pictog_ind == state_->selected_curve()->get_stats().switches_inds.size())
-        {
-            view = state_->selected_curve()->get_stats().dimensionality.back();
-        }
-        else
-        {
-            auto vert_ind =
-                state_->selected_curve()->get_stats().switches_inds[pictog_ind] - 1;
-            view = state_->selected_curve()->get_stats().dimensionality[vert_ind];
-        }
-
         Curve_selection selection;
         if(pictog_ind == 0)
         {
             selection.t_start = state_->selected_curve()->t_min();
             selection.t_end =
-                state_->selected_curve()->time_stamp()[state_->selected_curve()->get_stats()
-                                             .switches_inds.front()];
+                state_->selected_curve()->time_at(state_->selected_curve()->get_stats()
+                                             .switches_inds.front());
         }
         else if(pictog_ind == state_->selected_curve()->get_stats().switches_inds.size())
         {
             selection.t_start =
-                state_->selected_curve()->time_stamp()[state_->selected_curve()->get_stats()
-                                             .switches_inds.back()];
+                state_->selected_curve()->time_at(state_->selected_curve()->get_stats()
+                                             .switches_inds.back());
             selection.t_end = state_->selected_curve()->t_max();
         }
         else
         {
             selection.t_start =
-                state_->selected_curve()->time_stamp()[state_->selected_curve()->get_stats()
-                                             .switches_inds[pictog_ind - 1]];
+                state_->selected_curve()->time_at(state_->selected_curve()->get_stats()
+                                             .switches_inds[pictog_ind - 1]);
             selection.t_end =
-                state_->selected_curve()->time_stamp()[state_->selected_curve()->get_stats()
-                                             .switches_inds[pictog_ind]];
+                state_->selected_curve()->time_at(state_->selected_curve()->get_stats()
+                                             .switches_inds[pictog_ind]);
         }
 
         state_->curve_selection = std::make_unique<Curve_selection>(selection);
@@ -275,7 +271,7 @@ void Timeline_renderer::draw_axes(const Region& region)
     // Draw the bottom axis and the left axis
     auto draw_line = [this](glm::vec2 start, glm::vec2 end)
     {
-        Screen_shader::Line_strip line;
+        Screen_shader::Line_strip line(&frame_arena_);
         line.emplace_back(Screen_shader::Line_point(
             start, 1.5f, glm::vec4(0.f, 0.f, 0.f, 1.f)));
         line.emplace_back(Screen_shader::Line_point(
@@ -288,8 +284,8 @@ void Timeline_renderer::draw_axes(const Region& region)
     draw_line(glm::vec2(region.left(),  region.bottom()),
               glm::vec2(region.left(),  region.top()));
 
-    const float t_min = state_->selected_curve()->t_min();
-    const float t_max = state_->selected_curve()->t_max();
+    const float t_min = state_->timeline_curve()->t_min();
+    const float t_max = state_->timeline_curve()->t_max();
     const float t_durr = t_max - t_min;
 
     float dist = region.width() / num_section;
@@ -337,11 +333,13 @@ void Timeline_renderer::draw_axes(const Region& region)
 
 void Timeline_renderer::draw_curve(const Region& region)
 {
-    const float t_min = state_->selected_curve()->t_min();
-    const float t_max = state_->selected_curve()->t_max();
+    const auto curve = state_->timeline_curve();
+    const float t_min = curve->t_min();
+    const float t_max = curve->t_max();
     const float t_duration = t_max - t_min;
+    const auto& points = curve->points(timeline_buffer_);
 
-    auto get_strip = [this](
+    auto get_strip = [this, &curve, &points](
         const Region& region,
         size_t dim_ind,
         float t_duration,
@@ -351,22 +349,23 @@ void Timeline_renderer::draw_curve(const Region& region)
     {
         const float width = 2.5f;
 
-        Screen_shader::Line_strip strip;
+        Screen_shader::Line_strip strip(&frame_arena_);
 
         glm::vec2 prev_pnt;
-        const float t_min  = state_->selected_curve()->t_min();
+        const float t_min  = curve->t_min();
 
         const float min_delta_t = width * t_duration / region.width();
         float prev_t = -min_delta_t;
 
-        for(size_t i = 0; i < state_->selected_curve()->get_vertices().size(); i++)
+        const auto time_stamp = points.time();
+        const auto values = points.coord(dim_ind);
+        for(size_t i = 0; i < values.size(); i++)
         {
-            const float t_curr = state_->selected_curve()->time_stamp()[i];
+            const float t_curr = time_stamp[i];
             if(t_curr < prev_t + min_delta_t)
                 continue;
 
-            const float val = static_cast<float>(
-                state_->selected_curve()->get_vertices()[i](dim_ind));
+            const float val = values[i];
             const float x_point =
                 region.left() + region.width() * (t_curr - t_min) / t_duration;
             const float y_point =
@@ -400,7 +399,7 @@ void Timeline_renderer::draw_curve(const Region& region)
         return strip;
     };
 
-    std::vector<glm::vec4> colors;
+    std::pmr::vector<glm::vec4> colors(&frame_arena_);
     // #d7191c X-axis
     colors.emplace_back(glm::vec4(0.84f, 0.10f, 0.11f, 1.00f));
     // #fdae61 Y-axis
@@ -447,7 +446,7 @@ void Timeline_renderer::draw_switches(const Region& region)
     const float dash = 2.f,
                 gap  = 7.f;
 
-    std::vector<float> points;
+    std::pmr::vector<float> points(&frame_arena_);
     calculate_switch_points(points, region);
     for(auto p : points)
     {
@@ -456,7 +455,7 @@ void Timeline_renderer::draw_switches(const Region& region)
         float p_rounded = std::round(p) + 0.5f;
         for(float h = region.bottom(); h <= region.top(); h += dash + gap)
         {
-            Screen_shader::Line_strip line;
+            Screen_shader::Line_strip line(&frame_arena_);
             line.emplace_back(Screen_shader::Line_point(
                 glm::vec2(p_rounded, h), width, color));
             line.emplace_back(Screen_shader::Line_point(
@@ -479,7 +478,7 @@ void Timeline_renderer::draw_marker(const Region& region)
     float x_pos = region.left() + state_->timeplayer_pos * region.width();
     x_pos = std::round(x_pos) + 0.5f;
 
-    Screen_shader::Line_strip line;
+    Screen_shader::Line_strip line(&frame_arena_);
     line.emplace_back(Screen_shader::Line_point(
         glm::vec2(x_pos, region.top()), width, color));
     line.emplace_back(Screen_shader::Line_point(
@@ -509,12 +508,13 @@ void Timeline_renderer::draw_selection(const Region& region,
     }
     else
     {
+        const float t_min = state_->timeline_curve()->t_min();
         auto width_ratio = (region.right() - region.left()) /
-            state_->selected_curve()->t_duration();
+            state_->timeline_curve()->t_duration();
         auto left = region.left() +
-            state_->curve_selection->t_start * width_ratio;
+            (state_->curve_selection->t_start - t_min) * width_ratio;
         auto right = region.left() +
-            state_->curve_selection->t_end   * width_ratio;
+            (state_->curve_selection->t_end   - t_min) * width_ratio;
 
         const glm::vec4 background = glm::vec4(0.f, 0.f, 0.f, 0.07f);
 
@@ -543,7 +543,7 @@ void Timeline_renderer::draw_selection(const Region& region,
 
 void Timeline_renderer::draw_pictograms(
     const Region& region,
-    const std::vector<Compas_state>& compases_state)
+    const std::pmr::vector<Compas_state>& compases_state)
 {
     if(state_->selected_curve()->get_stats().switches_inds.size() == 0)
         return;
@@ -555,14 +555,14 @@ void Timeline_renderer::draw_pictograms(
     for(int i = 0; i < pictogram_num; ++i)
     {
         Curve_selection selection;
-        std::string dim;
+        Curve_stats::Dim_mask dim;
         Curve_stats::Range range = state_->selected_curve()->get_stats().range[i];
         if(i == 0)
         {
             selection.t_start = state_->selected_curve()->t_min();
             selection.t_end =
-                state_->selected_curve()->time_stamp()[state_->selected_curve()->get_stats()
-                                                .switches_inds[i]];
+                state_->selected_curve()->time_at(state_->selected_curve()->get_stats()
+                                                .switches_inds[i]);
 
             dim = state_->selected_curve()->get_stats().dimensionality.front();
         }
@@ -570,7 +570,7 @@ void Timeline_renderer::draw_pictograms(
         {
             size_t ind = state_->selected_curve()->get_stats().switches_inds[i - 1];
 
-            selection.t_start = state_->selected_curve()->time_stamp()[ind];
+            selection.t_start = state_->selected_curve()->time_at(ind);
             selection.t_end = state_->selected_curve()->t_max();
 
             dim = state_->selected_curve()->get_stats().dimensionality[ind];
@@ -579,10 +579,10 @@ void Timeline_renderer::draw_pictograms(
         {
             size_t ind = state_->selected_curve()->get_stats().switches_inds[i - 1];
 
-            selection.t_start = state_->selected_curve()->time_stamp()[ind];
+            selection.t_start = state_->selected_curve()->time_at(ind);
             selection.t_end =
-                state_->selected_curve()->time_stamp()[state_->selected_curve()->get_stats()
-                                                .switches_inds[i]];
+                state_->selected_curve()->time_at(state_->selected_curve()->get_stats()
+                                                .switches_inds[i]);
 
             dim = state_->selected_curve()->get_stats().dimensionality[ind];
         }
@@ -605,7 +605,7 @@ void Timeline_renderer::draw_pictograms(
 void Timeline_renderer::draw_pictogram(const glm::vec2& center,
                                        float size,
                                        const Curve_selection& seleciton,
-                                       std::string dim,
+                                       Curve_stats::Dim_mask dim,
                                        Curve_stats::Range range)
 {
     if(!state_->tesseract)
@@ -661,7 +661,7 @@ void Timeline_renderer::draw_pictogram(const glm::vec2& center,
             const float width(1.f);
             const glm::vec4 color(0.f, 0.f, 0.f, 1.f);
 
-            Screen_shader::Line_strip line;
+            Screen_shader::Line_strip line(&frame_arena_);
             line.emplace_back(Screen_shader::Line_point(
                 center + glm::vec2(v1(0), v1(1)), width, color));
             line.emplace_back(Screen_shader::Line_point(
@@ -672,41 +672,43 @@ void Timeline_renderer::draw_pictogram(const glm::vec2& center,
     };
 
     auto draw_curve =
-        [this, &center, &seleciton](const Curve& curve) {
-            for(auto& e : curve.edges())
+        [this, &center, &seleciton](
+            const Curve& curve,
+            const Point_store& view) {
+            const auto x = view.coord(0);
+            const auto y = view.coord(1);
+            const auto time_stamp = view.time();
+            for(size_t i = 0; i < curve.num_segments(); ++i)
             {
-                const auto& v1 = curve.vertices()[e.vert1];
-                const auto& v2 = curve.vertices()[e.vert2];
+                const glm::vec2 v1(x[i], y[i]);
+                const glm::vec2 v2(x[i + 1], y[i + 1]);
 
-                float t1 = curve.time_stamp()[e.vert1];
-                float t2 = curve.time_stamp()[e.vert2];
+                float t1 = time_stamp[i];
+                float t2 = time_stamp[i + 1];
 
                 if(seleciton.in_range(t1) && seleciton.in_range(t2))
                 {
                     const float width(1.f);
                     const glm::vec4 color(0.f, 0.f, 0.f, 1.f);
 
-                    Screen_shader::Line_strip line;
-                    line.emplace_back(Screen_shader::Line_point(
-                        center + glm::vec2(v1(0), v1(1)), width, color));
-                    line.emplace_back(Screen_shader::Line_point(
-                        center + glm::vec2(v2(0), v2(1)), width, color));
+                    Screen_shader::Line_strip line(&frame_arena_);
+                    line.emplace_back(
+                        Screen_shader::Line_point(center + v1, width, color));
+                    line.emplace_back(
+                        Screen_shader::Line_point(center + v2, width, color));
 
                     screen_shader_->append_to_geometry(*screen_geom_, line);
                 }
             }
         };
 
-    auto get_curve_speed = [this, &seleciton](Curve& curve) {
+    auto get_curve_speed = [this, &seleciton](const Curve& curve) {
         auto speed = std::numeric_limits<float>::min();
-        for(auto& e : curve.edges())
+        const auto time_stamp = selected_points_->time();
+        for(size_t i = 0; i < curve.num_segments(); ++i)
         {
-            const auto& v1 = curve.vertices()[e.vert1];
-            float t = curve.time_stamp()[e.vert1];
-            if(seleciton.in_range(t))
-            {
-                speed = std::max(speed, curve.get_stats().speed[e.vert1]);
-            }
+            if(seleciton.in_range(time_stamp[i]))
+                speed = std::max(speed, curve.get_stats().speed[i]);
         }
 
         float norm_speed =
@@ -739,63 +741,50 @@ void Timeline_renderer::draw_pictogram(const glm::vec2& center,
     std::unique_ptr<Square> square;
     std::unique_ptr<Tesseract> tesseract;
 
-    if(dim == "xyz")
+    const int num_dims = Curve_stats::num_dims(dim);
+    const Curve_stats::Dim_mask x = Curve_stats::Dim_x, y = Curve_stats::Dim_y,
+                                z = Curve_stats::Dim_z, w = Curve_stats::Dim_w;
+    if(dim == (x | y | z))
     {
         if(average_range(3) > 0)
             cube = std::make_unique<Cube>(cubes[0]);
         else
             cube = std::make_unique<Cube>(cubes[1]);
     }
-    else if(dim == "xyw")
+    else if(dim == (x | y | w))
     {
         if(average_range(2) > 0)
             cube = std::make_unique<Cube>(cubes[2]);
         else
             cube = std::make_unique<Cube>(cubes[3]);
     }
-    else if(dim == "xzw")
+    else if(dim == (x | z | w))
     {
         if(average_range(1) > 0)
             cube = std::make_unique<Cube>(cubes[5]);
         else
             cube = std::make_unique<Cube>(cubes[4]);
     }
-    else if(dim == "yzw")
+    else if(dim == (y | z | w))
     {
         if(average_range(0) > 0)
             cube = std::make_unique<Cube>(cubes[7]);
         else
             cube = std::make_unique<Cube>(cubes[6]);
     }
-    else if(dim.size() == 2)
+    else if(num_dims == 2)
     {
         // This code below generates mask to acess the right tesseract plane.
-        // It might be hard to understand, sorry.
-
-        // 'n' = not defined
-        std::string mask = "nnnn";
-
-        for(char i = 0; i < 2; ++i)
-        {
-            // fix axes
-            if(dim[i] == 'x')
-                mask[0] = 'x';
-            else if(dim[i] == 'y')
-                mask[1] = 'y';
-            else if(dim[i] == 'z')
-                mask[2] = 'z';
-            else if(dim[i] == 'w')
-                mask[3] = 'w';
-        }
-
+        // The active axes are kept, the others are fixed to one side
+        std::string mask = "xyzw";
         for(char i = 0; i < 4; ++i)
         {
-            if(mask[i] == 'n')
+            if(!(dim & 1 << i))
                 mask[i] = average_range(i) > 0 ? '1' : '0';
         }
         square = std::make_unique<Square>(state_->tesseract->get_plain(mask));
     }
-    else if(dim.size() == 4)
+    else if(num_dims == 4)
     {
         tesseract = std::make_unique<Tesseract>(*state_->tesseract.get());
     }
@@ -837,9 +826,10 @@ void Timeline_renderer::draw_pictogram(const glm::vec2& center,
     project_point_array(t.get_vertices(), size);
     draw_wireframe_obj(t);
 
-    Curve c = *state_->selected_curve().get();
-    project_point_array(c.get_vertices(), size);
-    draw_curve(c);
+    const Curve& c = *state_->selected_curve();
+    pictogram_view_ = *selected_points_;
+    project_point_array(pictogram_view_, size);
+    draw_curve(c, pictogram_view_);
 }
 
 //******************************************************************************
@@ -848,9 +838,9 @@ void Timeline_renderer::draw_pictogram(const glm::vec2& center,
 
 void Timeline_renderer::highlight_hovered_region(
     const Region& region,
-    const std::vector<Compas_state>& compases_state)
+    const std::pmr::vector<Compas_state>& compases_state)
 {
-    std::vector<float> points;
+    std::pmr::vector<float> points(&frame_arena_);
     calculate_switch_points(points, region);
 
     // Add first and last points for convenience
@@ -885,7 +875,7 @@ void Timeline_renderer::highlight_hovered_region(
 // get_compases_state
 //******************************************************************************
 
-std::vector<Timeline_renderer::Compas_state>
+std::pmr::vector<Timeline_renderer::Compas_state>
 Timeline_renderer::get_compases_state(const Region& region)
 {
     size_t pictogram_num = state_->selected_curve()->get_stats().switches_inds.size() + 1;
@@ -898,7 +888,7 @@ Timeline_renderer::get_compases_state(const Region& region)
     float x_pos = region.left() +
         0.5f * ( region.width() - required_width + pictogram_size_);
     
-    std::vector<Compas_state> pos_and_scale;
+    std::pmr::vector<Compas_state> pos_and_scale(&frame_arena_);
     for(int i = 0; i < pictogram_num; ++i)
     {
         pos_and_scale.emplace_back(Compas_state(x_pos, 1.f));
@@ -1016,8 +1006,8 @@ void Timeline_renderer::make_selection(const Mouse_selection& s)
         x_max = get_local_coord(s.start_pnt.x);
     }
 
-    auto t_start  = state_->selected_curve()->t_min();
-    auto t_end    = state_->selected_curve()->t_max();
+    auto t_start  = state_->timeline_curve()->t_min();
+    auto t_end    = state_->timeline_curve()->t_max();
     auto t_length = t_end - t_start;
 
     // FIXME: the current approach works only if the curve is defined by points
@@ -1032,20 +1022,23 @@ void Timeline_renderer::make_selection(const Mouse_selection& s)
 //******************************************************************************
 
 void Timeline_renderer::calculate_switch_points(
-    std::vector<float>& out_points,
+    std::pmr::vector<float>& out_points,
     const Region& region)
 {
-    if(state_->selected_curve()->time_stamp().size() == 0)
+    if(state_->selected_curve()->size() == 0)
         return;
 
-    float t_min = state_->selected_curve()->t_min();
-    float t_max = state_->selected_curve()->t_max();
+    // The switches of the selected curve are placed on the time axis of the
+    // timeline, which spans the whole trajectory if only a window is loaded
+    float t_min = state_->timeline_curve()->t_min();
+    float t_max = state_->timeline_curve()->t_max();
     float t_duration = t_max - t_min;
 
     for(auto s : state_->selected_curve()->get_stats().switches_inds)
     {
         float x_pos = region.left() +
-                      region.width() * state_->selected_curve()->time_stamp()[s] /
+                      region.width() *
+                      (state_->selected_curve()->time_at(s) - t_min) /
                       t_duration;
         out_points.push_back(x_pos);
     }
@@ -1100,6 +1093,33 @@ void Timeline_renderer::project_point_array(
         project_point(p, size);
 }
 
+//******************************************************************************
+// project_point_array
+//
+// Only x and y of the points are changed, the same as for the vertices
+//******************************************************************************
+
+void Timeline_renderer::project_point_array(
+    Point_store& points,
+    float size)
+{
+    auto x = points.coord(0), y = points.coord(1), z = points.coord(2),
+         w = points.coord(3);
+
+    // A single vertex is reused for all the points
+    Scene_vertex_t p(4);
+    for(size_t i = 0; i < points.size(); ++i)
+    {
+        p(0) = x[i];
+        p(1) = y[i];
+        p(2) = z[i];
+        p(3) = w[i];
+        project_point(p, size);
+        x[i] = p(0);
+        y[i] = p(1);
+    }
+}
+
 //******************************************************************************
 // update_regions
 //******************************************************************************
@@ -1,6 +1,7 @@
 #pragma once
 // local
 #include "Base_renderer.h"
+#include "Frame_arena.h"
 #include "Geometry_engine.h"
 #include "Scene_state.h"
 #include "Screen_shader.h"
@@ -65,23 +66,23 @@ private:
     void draw_marker(    const Region& region);
     void draw_selection( const Region& region, const Mouse_selection& s);
     void draw_pictograms(const Region& region,
-                         const std::vector<Compas_state>& compases_state);
+                         const std::pmr::vector<Compas_state>& compases_state);
     void draw_pictogram(
         const glm::vec2& center,
         float size,
         const Curve_selection& seleciton,
-        std::string dim,
+        Curve_stats::Dim_mask dim,
         Curve_stats::Range range);
 
     void highlight_hovered_region(
         const Region& region,
-        const std::vector<Compas_state>& compases_state);
+        const std::pmr::vector<Compas_state>& compases_state);
 
-    std::vector<Compas_state> get_compases_state(const Region& region);
+    std::pmr::vector<Compas_state> get_compases_state(const Region& region);
 
     void make_selection(const Mouse_selection& s);
     void calculate_switch_points(
-        std::vector<float>& out_points,
+        std::pmr::vector<float>& out_points,
         const Region& region);
 
     void project_point(
@@ -90,6 +91,9 @@ private:
     void project_point_array(
         std::vector<Scene_vertex_t>& points,
         float size);
+    void project_point_array(
+        Point_store& points,
+        float size);
 
     void update_regions();
 
@@ -115,4 +119,15 @@ private:
     float splitter_;
 
     std::vector<bool> show_axes_;
+
+    // Temporary objects of the current frame
+    Frame_arena frame_arena_;
+
+    // Points of the selected curve and the timeline curve, the buffers hold
+    // the decoded points of the quantized curves
+    const Point_store* selected_points_ = nullptr;
+    Point_store selected_buffer_, timeline_buffer_;
+
+    // Projected points of the selected curve, reused by the pictograms
+    Point_store pictogram_view_;
 };
@@ -0,0 +1,77 @@
+#include "Trajectory_buffer.h"
+// std
+#include <utility>
+
+//******************************************************************************
+// Trajectory_buffer
+//******************************************************************************
+
+Trajectory_buffer::Trajectory_buffer(
+    std::shared_ptr<const char> data,
+    size_t size,
+    const std::string& name/* = std::string()*/)
+    : data_(std::move(data)),
+      size_(size),
+      name_(name)
+{
+}
+
+//******************************************************************************
+// view
+//******************************************************************************
+
+Trajectory_buffer Trajectory_buffer::view(
+    const char* data,
+    size_t size,
+    const std::string& name/* = std::string()*/)
+{
+    // The pointer does not own the memory, so nothing is released
+    return Trajectory_buffer(
+        std::shared_ptr<const char>(data, [](const char*) {}),
+        size,
+        name);
+}
+
+//******************************************************************************
+// take
+//******************************************************************************
+
+Trajectory_buffer Trajectory_buffer::take(
+    std::vector<char>&& data,
+    const std::string& name/* = std::string()*/)
+{
+    // The moved vector keeps its memory, the pointer aliases its content
+    auto owner = std::make_shared<const std::vector<char>>(std::move(data));
+    const size_t size = owner->size();
+    return Trajectory_buffer(
+        std::shared_ptr<const char>(owner, owner->data()),
+        size,
+        name);
+}
+
+//******************************************************************************
+// data
+//******************************************************************************
+
+const char* Trajectory_buffer::data() const
+{
+    return data_.get();
+}
+
+//******************************************************************************
+// size
+//******************************************************************************
+
+size_t Trajectory_buffer::size() const
+{
+    return size_;
+}
+
+//******************************************************************************
+// name
+//******************************************************************************
+
+const std::string& Trajectory_buffer::name() const
+{
+    return name_;
+}
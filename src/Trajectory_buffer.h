@@ -0,0 +1,44 @@
+#pragma once
+// std
+#include <memory>
+#include <string>
+#include <vector>
+
+// Content of a trajectory file that is already in memory, e.g. received from
+// the browser or produced by the embedding application. The buffer is loaded
+// the same way as a file without writing it to the disk. The name is used as
+// the file name: its extension selects the format (see Binary_trajectory).
+//
+// The buffer either references the memory of the caller, which has to stay
+// valid while the buffer is used, or owns the memory. Copies of an owning
+// buffer share the memory, so it is never copied.
+class Trajectory_buffer
+{
+public:
+    Trajectory_buffer() = default;
+    // Takes the ownership of the memory, it is released by the deleter of the
+    // pointer when the last copy of the buffer is destroyed
+    Trajectory_buffer(
+        std::shared_ptr<const char> data,
+        size_t size,
+        const std::string& name = std::string());
+
+    // References the memory without taking the ownership
+    static Trajectory_buffer view(
+        const char* data,
+        size_t size,
+        const std::string& name = std::string());
+    // Moves the vector into the buffer
+    static Trajectory_buffer take(
+        std::vector<char>&& data,
+        const std::string& name = std::string());
+
+    const char* data() const;
+    size_t size() const;
+    const std::string& name() const;
+
+private:
+    std::shared_ptr<const char> data_;
+    size_t size_ = 0;
+    std::string name_;
+};
@@ -0,0 +1,303 @@
+#include "Trajectory_cache.h"
+// Local
+#include "Mapped_file.h"
+#include "Stamped_file.h"
+// std
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+namespace
+{
+const char     Magic[8] = {'M', 'L', 'C', 'A', 'C', 'H', 'E', '\0'};
+const uint32_t Version  = 4;
+
+struct Header
+{
+    Stamped_file::Stamp stamp;
+    uint64_t num_points;
+    float    origin[4];
+    float    size[4];
+    uint64_t parsed_size; // Size of the complete lines of the source file
+    uint8_t  reserved[8];
+};
+static_assert(sizeof(Header) == 128, "The cache header must be 128 bytes");
+
+//******************************************************************************
+// open_cache
+//
+// Maps the cache and checks that it matches the source file and the columns
+//******************************************************************************
+
+bool open_cache(
+    const std::string& source_fname,
+    const Trajectory_parser::Columns& columns,
+    Mapped_file& file,
+    Header& header)
+{
+    file.open(Trajectory_cache::cache_name(source_fname));
+    if(!file.is_open() || file.size() < sizeof(Header))
+        return false;
+
+    std::memcpy(&header, file.data(), sizeof(Header));
+    if(!Stamped_file::is_valid(
+            header.stamp, Magic, Version, source_fname, columns))
+    {
+        return false;
+    }
+
+    const size_t n = static_cast<size_t>(header.num_points);
+    return file.size() == sizeof(Header) + 5 * n * sizeof(float);
+}
+
+//******************************************************************************
+// column_data
+//
+// Columns are stored one after another right after the header
+//******************************************************************************
+
+const float* column_data(
+    const Mapped_file& file,
+    const Header& header,
+    size_t i)
+{
+    return reinterpret_cast<const float*>(
+        file.data() + sizeof(Header) + i * header.num_points * sizeof(float));
+}
+
+//******************************************************************************
+// copy_rows
+//
+// Copies every `stride`-th row of [first, last) and the last row of the range.
+// The boundaries are the ones of the whole trajectory
+//******************************************************************************
+
+void copy_rows(
+    const Mapped_file& file,
+    const Header& header,
+    size_t first,
+    size_t last,
+    size_t stride,
+    Trajectory_data& out)
+{
+    for(size_t i = 0; i < 5; ++i)
+    {
+        auto column = column_data(file, header, i);
+        auto& out_column = out.column(i);
+        if(stride == 1)
+        {
+            out_column.assign(column + first, column + last);
+            continue;
+        }
+
+        out_column.clear();
+        for(size_t r = first; r < last; r += stride)
+            out_column.push_back(column[r]);
+        if(last > first && (last - 1 - first) % stride != 0)
+            out_column.push_back(column[last - 1]);
+    }
+
+    for(size_t i = 0; i < 4; ++i)
+    {
+        out.origin[i] = header.origin[i];
+        out.extent[i] = header.size[i];
+    }
+}
+} // namespace
+
+//******************************************************************************
+// cache_name
+//******************************************************************************
+
+std::string Trajectory_cache::cache_name(const std::string& source_fname)
+{
+    return source_fname + ".mlcache";
+}
+
+//******************************************************************************
+// get_source_stamp
+//******************************************************************************
+
+bool Trajectory_cache::get_source_stamp(
+    const std::string& fname,
+    uint64_t& out_size,
+    int64_t& out_mtime)
+{
+    std::error_code ec;
+    out_size = std::filesystem::file_size(fname, ec);
+    if(ec)
+        return false;
+
+    auto time = std::filesystem::last_write_time(fname, ec);
+    if(ec)
+        return false;
+    out_mtime = static_cast<int64_t>(time.time_since_epoch().count());
+
+    return true;
+}
+//******************************************************************************
+// load
+//******************************************************************************
+
+bool Trajectory_cache::load(
+    const std::string& source_fname,
+    Trajectory_data& out,
+    size_t* parsed_size/* = nullptr*/,
+    const Trajectory_parser::Columns& columns/* = Default_columns*/)
+{
+    Mapped_file file;
+    Header header;
+    if(!open_cache(source_fname, columns, file, header))
+        return false;
+
+    copy_rows(file, header, 0, header.num_points, 1, out);
+
+    if(parsed_size != nullptr)
+        *parsed_size = static_cast<size_t>(header.parsed_size);
+
+    return true;
+}
+
+//******************************************************************************
+// load_points
+//
+// The kept points are counted first, so the store is allocated once with the
+// size of the compacted curve
+//******************************************************************************
+
+bool Trajectory_cache::load_points(
+    const std::string& source_fname,
+    float stationary_epsilon,
+    Point_store& out,
+    std::array<float, 4>& origin,
+    std::array<float, 4>& extent,
+    size_t* parsed_size/* = nullptr*/,
+    const Trajectory_parser::Columns& columns/* = Default_columns*/)
+{
+    Mapped_file file;
+    Header header;
+    if(!open_cache(source_fname, columns, file, header))
+        return false;
+
+    const size_t n = static_cast<size_t>(header.num_points);
+    std::array<const float*, 4> coords;
+    for(size_t i = 0; i < 4; ++i)
+    {
+        coords[i] = column_data(file, header, i + 1);
+        origin[i] = header.origin[i];
+        extent[i] = header.size[i];
+    }
+    auto time = column_data(file, header, 0);
+
+    size_t num_kept = 0;
+    for_each_non_stationary(
+        coords, n, extent, stationary_epsilon, [&num_kept](size_t) {
+            ++num_kept;
+        });
+
+    out.resize(num_kept);
+    auto out_time = out.time();
+    std::array<Span<float>, 4> out_coords = {
+        out.coord(0), out.coord(1), out.coord(2), out.coord(3)};
+    size_t kept = 0;
+    for_each_non_stationary(
+        coords, n, extent, stationary_epsilon, [&](size_t i) {
+            out_time[kept] = time[i];
+            for(size_t k = 0; k < 4; ++k)
+                out_coords[k][kept] = coords[k][i];
+            ++kept;
+        });
+    std::fill(out.coord(4).begin(), out.coord(4).end(), 1.f);
+
+    if(parsed_size != nullptr)
+        *parsed_size = static_cast<size_t>(header.parsed_size);
+
+    return true;
+}
+
+//******************************************************************************
+// load_window
+//******************************************************************************
+
+bool Trajectory_cache::load_window(
+    const std::string& source_fname,
+    float t_begin,
+    float t_end,
+    Trajectory_data& out,
+    const Trajectory_parser::Columns& columns/* = Default_columns*/)
+{
+    Mapped_file file;
+    Header header;
+    if(!open_cache(source_fname, columns, file, header))
+        return false;
+
+    // The time column is sorted, so the window is found by the binary search
+    auto time = column_data(file, header, 0);
+    auto time_end = time + header.num_points;
+    const size_t first = std::lower_bound(time, time_end, t_begin) - time;
+    const size_t last = std::upper_bound(time, time_end, t_end) - time;
+
+    copy_rows(file, header, first, std::max(first, last), 1, out);
+    return true;
+}
+
+//******************************************************************************
+// load_summary
+//******************************************************************************
+
+bool Trajectory_cache::load_summary(
+    const std::string& source_fname,
+    size_t stride,
+    Trajectory_data& out,
+    const Trajectory_parser::Columns& columns/* = Default_columns*/)
+{
+    Mapped_file file;
+    Header header;
+    if(!open_cache(source_fname, columns, file, header))
+        return false;
+
+    copy_rows(file, header, 0, header.num_points, stride, out);
+    return true;
+}
+
+//******************************************************************************
+// save
+//******************************************************************************
+
+bool Trajectory_cache::save(
+    const std::string& source_fname,
+    const Trajectory_data& data,
+    size_t parsed_size,
+    const Trajectory_parser::Columns& columns/* = Default_columns*/)
+{
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    if(!Stamped_file::make_stamp(
+            Magic, Version, source_fname, columns, header.stamp))
+    {
+        return false;
+    }
+    header.num_points = data.size();
+    header.parsed_size = parsed_size;
+    for(size_t i = 0; i < 4; ++i)
+    {
+        header.origin[i] = data.origin[i];
+        header.size[i] = data.extent[i];
+    }
+
+    return Stamped_file::write(
+        cache_name(source_fname), [&header, &data](std::ostream& stream) {
+            auto write_column = [&stream](const std::vector<float>& c) {
+                stream.write(reinterpret_cast<const char*>(c.data()),
+                             c.size() * sizeof(float));
+            };
+
+            stream.write(
+                reinterpret_cast<const char*>(&header), sizeof(Header));
+            write_column(data.time);
+            for(const auto& c : data.coords)
+                write_column(c);
+        });
+}
@@ -0,0 +1,83 @@
+#pragma once
+// Local
+#include "Point_store.h"
+#include "Trajectory_data.h"
+#include "Trajectory_parser.h"
+// std
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Binary cache of parsed trajectory files. The cache is stored next to the
+// source file with the ".mlcache" extension and consists of a fixed-size header
+// followed by the time column and the four coordinate columns (float32 each).
+// The header starts with a Stamped_file::Stamp and keeps the size of the parsed
+// part of the source file, so a stale cache is detected and ignored.
+namespace Trajectory_cache
+{
+std::string cache_name(const std::string& source_fname);
+
+// Reads the size and the modification time of the source file, which identify
+// the version of the file the cache is created from
+bool get_source_stamp(
+    const std::string& source_fname,
+    uint64_t& out_size,
+    int64_t& out_mtime);
+
+// Maps the cache of the source file and reads the columns. The mapped columns
+// are copied into `out` as a whole, a curve is filled with load_points()
+// without this copy. Returns false if there is no cache or it does not match
+// the source file or the columns. If `parsed_size` is provided, it receives
+// the size of the part of the source file the cache was created from, a last
+// incomplete line is not included
+bool load(
+    const std::string& source_fname,
+    Trajectory_data& out,
+    size_t* parsed_size = nullptr,
+    const Trajectory_parser::Columns& columns =
+        Trajectory_parser::Default_columns);
+
+// Copies the columns from the mapped cache right into the points of a curve
+// and leaves out the stationary points on the way, the same as
+// Trajectory_data::compact_stationary. The homogeneous coordinate is 1.
+// `origin` and `extent` receive the boundaries of the whole trajectory
+bool load_points(
+    const std::string& source_fname,
+    float stationary_epsilon,
+    Point_store& out,
+    std::array<float, 4>& origin,
+    std::array<float, 4>& extent,
+    size_t* parsed_size = nullptr,
+    const Trajectory_parser::Columns& columns =
+        Trajectory_parser::Default_columns);
+
+// Reads only the rows with the time in [t_begin, t_end]. The time stamps have
+// to be sorted. The boundaries are the ones of the whole trajectory
+bool load_window(
+    const std::string& source_fname,
+    float t_begin,
+    float t_end,
+    Trajectory_data& out,
+    const Trajectory_parser::Columns& columns =
+        Trajectory_parser::Default_columns);
+
+// Reads every `stride`-th row and the last row, which is a coarse overview of
+// the whole trajectory
+bool load_summary(
+    const std::string& source_fname,
+    size_t stride,
+    Trajectory_data& out,
+    const Trajectory_parser::Columns& columns =
+        Trajectory_parser::Default_columns);
+
+// Writes the cache for the source file, the data parsed from its first
+// `parsed_size` bytes. Returns false if the cache cannot be written, e.g., the
+// directory is read-only
+bool save(
+    const std::string& source_fname,
+    const Trajectory_data& data,
+    size_t parsed_size,
+    const Trajectory_parser::Columns& columns =
+        Trajectory_parser::Default_columns);
+
+} // namespace Trajectory_cache
@@ -0,0 +1,143 @@
+#pragma once
+// std
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Calls `keep` with the index of every point that compact_stationary() keeps
+// of the columns x, y, z, w with `n` points each, in the increasing order.
+// The extent is the one of the bounding box of the columns
+template<typename Keep>
+void for_each_non_stationary(
+    const std::array<const float*, 4>& coords,
+    size_t n,
+    const std::array<float, 4>& extent,
+    float epsilon,
+    Keep keep)
+{
+    std::array<float, 4> inv_extent;
+    for(size_t i = 0; i < 4; ++i)
+        inv_extent[i] = extent[i] > 0.f ? 1.f / extent[i] : 0.f;
+    const float epsilon_sq = epsilon * epsilon;
+
+    auto is_close = [&coords, &inv_extent, epsilon_sq](size_t a, size_t b) {
+        float dist_sq = 0.f;
+        for(size_t i = 0; i < 4; ++i)
+        {
+            const float d = (coords[i][b] - coords[i][a]) * inv_extent[i];
+            dist_sq += d * d;
+        }
+        return dist_sq < epsilon_sq;
+    };
+
+    size_t run_begin = 0;
+    while(run_begin < n)
+    {
+        size_t run_end = run_begin + 1;
+        while(run_end < n && is_close(run_begin, run_end))
+            ++run_end;
+
+        keep(run_begin);
+        if(run_end - run_begin > 1)
+            keep(run_end - 1);
+        run_begin = run_end;
+    }
+}
+
+// Columnar representation of a trajectory: time stamps and the four state
+// variables are kept in separate contiguous arrays of the same length
+struct Trajectory_data
+{
+    std::vector<float> time;
+    std::array<std::vector<float>, 4> coords; // x, y, z, w
+
+    // Bounding box of the state variables (minimum and extent), the same as
+    // Vertex_object::get_boundaries returns. Filled by update_boundaries()
+    std::array<float, 4> origin = {};
+    std::array<float, 4> extent = {};
+
+    size_t size() const
+    {
+        return time.size();
+    }
+
+    // The column by the index: 0 is the time, 1 to 4 are x, y, z, w
+    std::vector<float>& column(size_t i)
+    {
+        return i == 0 ? time : coords[i - 1];
+    }
+
+    const std::vector<float>& column(size_t i) const
+    {
+        return i == 0 ? time : coords[i - 1];
+    }
+
+    void reserve(size_t n)
+    {
+        time.reserve(n);
+        for(auto& c : coords)
+            c.reserve(n);
+    }
+
+    void push_back(float t, float x, float y, float z, float w)
+    {
+        time.push_back(t);
+        coords[0].push_back(x);
+        coords[1].push_back(y);
+        coords[2].push_back(z);
+        coords[3].push_back(w);
+    }
+
+    void update_boundaries()
+    {
+        for(size_t i = 0; i < 4; ++i)
+        {
+            if(coords[i].empty())
+            {
+                origin[i] = extent[i] = 0.f;
+                continue;
+            }
+
+            auto min_max =
+                std::minmax_element(coords[i].begin(), coords[i].end());
+            origin[i] = *min_max.first;
+            extent[i] = *min_max.second - *min_max.first;
+        }
+    }
+
+    // Replaces every run of points that stay closer than `epsilon` to the
+    // first point of the run by the first and the last point of the run, so
+    // the time stamps of the run are kept. The distance is measured in the
+    // units of the bounding box (the extent of every state variable is 1),
+    // which has to be up to date. The boundaries are not changed. Returns the
+    // number of removed points
+    size_t compact_stationary(float epsilon)
+    {
+        const size_t n = size();
+        if(epsilon <= 0.f || n < 3)
+            return 0;
+
+        std::array<const float*, 4> columns;
+        for(size_t i = 0; i < 4; ++i)
+            columns[i] = coords[i].data();
+
+        // The points are moved to the front in place, `kept` is the number
+        // of the points already moved. A run is visited after it is found, so
+        // the moved points are never read again
+        size_t kept = 0;
+        for_each_non_stationary(
+            columns, n, extent, epsilon, [this, &kept](size_t i) {
+                time[kept] = time[i];
+                for(auto& c : coords)
+                    c[kept] = c[i];
+                ++kept;
+            });
+
+        time.resize(kept);
+        for(auto& c : coords)
+            c.resize(kept);
+
+        return n - kept;
+    }
+};
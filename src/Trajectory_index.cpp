@@ -0,0 +1,227 @@
+#include "Trajectory_index.h"
+// Local
+#include "Mapped_file.h"
+#include "Stamped_file.h"
+// std
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+const char     Magic[8] = {'M', 'L', 'I', 'N', 'D', 'E', 'X', '\0'};
+const uint32_t Version  = 2;
+
+struct Header
+{
+    Stamped_file::Stamp stamp;
+    uint64_t num_offsets;
+    uint64_t num_summary_rows;
+    float    origin[4];
+    float    size[4];
+    uint8_t  reserved[8];
+};
+static_assert(sizeof(Header) == 128, "The index header must be 128 bytes");
+} // namespace
+
+//******************************************************************************
+// index_name
+//******************************************************************************
+
+std::string Trajectory_index::index_name(const std::string& source_fname)
+{
+    return source_fname + ".mlindex";
+}
+
+//******************************************************************************
+// build
+//******************************************************************************
+
+void Trajectory_index::build(
+    const Trajectory_data& data,
+    const std::vector<Trajectory_parser::Row_offset>& row_offsets,
+    Index& out)
+{
+    out.offsets.clear();
+    out.summary = Trajectory_data();
+    out.summary.reserve(row_offsets.size() + 1);
+
+    auto add_row = [&data, &out](size_t row) {
+        out.summary.push_back(
+            data.time[row],
+            data.coords[0][row],
+            data.coords[1][row],
+            data.coords[2][row],
+            data.coords[3][row]);
+    };
+
+    for(const auto& ro : row_offsets)
+    {
+        out.offsets.push_back(ro.offset);
+        add_row(static_cast<size_t>(ro.row));
+    }
+    if(data.size() > 0)
+        add_row(data.size() - 1);
+
+    out.summary.origin = data.origin;
+    out.summary.extent = data.extent;
+}
+
+//******************************************************************************
+// load
+//******************************************************************************
+
+bool Trajectory_index::load(
+    const std::string& source_fname,
+    Index& out,
+    const Trajectory_parser::Columns& columns/* = Default_columns*/)
+{
+    Mapped_file file(index_name(source_fname));
+    if(!file.is_open() || file.size() < sizeof(Header))
+        return false;
+
+    Header header;
+    std::memcpy(&header, file.data(), sizeof(Header));
+    if(!Stamped_file::is_valid(
+            header.stamp, Magic, Version, source_fname, columns))
+    {
+        return false;
+    }
+
+    const size_t num_offsets = static_cast<size_t>(header.num_offsets);
+    const size_t num_rows = static_cast<size_t>(header.num_summary_rows);
+    if(file.size() != sizeof(Header) + num_offsets * sizeof(uint64_t) +
+                          5 * num_rows * sizeof(float))
+    {
+        return false;
+    }
+
+    // The offsets are followed by the columns of the summary
+    const char* data = file.data() + sizeof(Header);
+    out.offsets.resize(num_offsets);
+    std::memcpy(out.offsets.data(), data, num_offsets * sizeof(uint64_t));
+    data += num_offsets * sizeof(uint64_t);
+
+    for(size_t i = 0; i < 5; ++i)
+    {
+        auto column = reinterpret_cast<const float*>(data);
+        out.summary.column(i).assign(column, column + num_rows);
+        data += num_rows * sizeof(float);
+    }
+
+    for(size_t i = 0; i < 4; ++i)
+    {
+        out.summary.origin[i] = header.origin[i];
+        out.summary.extent[i] = header.size[i];
+    }
+
+    return true;
+}
+
+//******************************************************************************
+// save
+//******************************************************************************
+
+bool Trajectory_index::save(
+    const std::string& source_fname,
+    const Index& index,
+    const Trajectory_parser::Columns& columns/* = Default_columns*/)
+{
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    if(!Stamped_file::make_stamp(
+            Magic, Version, source_fname, columns, header.stamp))
+    {
+        return false;
+    }
+    header.num_offsets = index.offsets.size();
+    header.num_summary_rows = index.summary.size();
+    for(size_t i = 0; i < 4; ++i)
+    {
+        header.origin[i] = index.summary.origin[i];
+        header.size[i] = index.summary.extent[i];
+    }
+
+    return Stamped_file::write(
+        index_name(source_fname), [&header, &index](std::ostream& stream) {
+            stream.write(
+                reinterpret_cast<const char*>(&header), sizeof(Header));
+            stream.write(
+                reinterpret_cast<const char*>(index.offsets.data()),
+                index.offsets.size() * sizeof(uint64_t));
+            for(size_t i = 0; i < 5; ++i)
+            {
+                const auto& c = index.summary.column(i);
+                stream.write(reinterpret_cast<const char*>(c.data()),
+                             c.size() * sizeof(float));
+            }
+        });
+}
+
+//******************************************************************************
+// load_window
+//******************************************************************************
+
+bool Trajectory_index::load_window(
+    const std::string& source_fname,
+    const Index& index,
+    float t_begin,
+    float t_end,
+    Trajectory_data& out,
+    const Trajectory_parser::Columns& columns/* = Default_columns*/)
+{
+    Mapped_file file(source_fname);
+    if(!file.is_open())
+        return false;
+
+    // The parsing starts at the last indexed row before the window and stops
+    // at the first indexed row after it
+    const auto& time = index.summary.time;
+    const auto indexed_end = time.begin() + index.offsets.size();
+    const size_t first =
+        std::lower_bound(time.begin(), indexed_end, t_begin) - time.begin();
+    const size_t last =
+        std::upper_bound(time.begin(), indexed_end, t_end) - time.begin();
+
+    // A last line that is still being written is not parsed, the same as
+    // when the index was built
+    const char* file_end = file.data() + file.size();
+    while(file_end != file.data() && *(file_end - 1) != '\n')
+        --file_end;
+
+    const size_t begin_offset = first == 0 ? 0 : index.offsets[first - 1];
+    const size_t end_offset = last == index.offsets.size() ?
+        static_cast<size_t>(file_end - file.data()) :
+        static_cast<size_t>(index.offsets[last]);
+    if(begin_offset > end_offset || end_offset > file.size())
+        return false;
+
+    Trajectory_data parsed;
+    Trajectory_parser::parse_parallel(
+        file.data() + begin_offset,
+        file.data() + end_offset,
+        parsed,
+        nullptr,
+        columns);
+
+    // Cut the rows outside of the window
+    const size_t first_row =
+        std::lower_bound(parsed.time.begin(), parsed.time.end(), t_begin) -
+        parsed.time.begin();
+    const size_t last_row =
+        std::upper_bound(parsed.time.begin(), parsed.time.end(), t_end) -
+        parsed.time.begin();
+
+    for(size_t i = 0; i < 5; ++i)
+    {
+        const auto& src = parsed.column(i);
+        if(src.empty())
+            continue;
+        out.column(i).assign(
+            src.begin() + first_row,
+            src.begin() + std::max(first_row, last_row));
+    }
+    out.origin = index.summary.origin;
+    out.extent = index.summary.extent;
+
+    return true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+// Local
+#include "Trajectory_data.h"
+#include "Trajectory_parser.h"
+// std
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Sparse index of a text trajectory file. The index keeps the byte offsets and
+// the values of some of the rows, not more than Stride rows apart. A time
+// window is then parsed without reading the rest of the file, and the indexed
+// rows give a coarse overview of the whole trajectory. The time stamps of the
+// file have to be sorted. The index is stored next to the source file with the
+// ".mlindex" extension and starts with a Stamped_file::Stamp.
+namespace Trajectory_index
+{
+const size_t Stride = 4096;
+
+struct Index
+{
+    std::vector<uint64_t> offsets; // Byte offsets of the indexed rows
+    // The indexed rows followed by the last row of the file. The boundaries
+    // are the ones of the whole trajectory
+    Trajectory_data summary;
+};
+
+std::string index_name(const std::string& source_fname);
+
+// Creates the index from a parsed file and the row offsets collected by the
+// parser. The boundaries of `data` have to be up to date
+void build(
+    const Trajectory_data& data,
+    const std::vector<Trajectory_parser::Row_offset>& row_offsets,
+    Index& out);
+
+bool load(
+    const std::string& source_fname,
+    Index& out,
+    const Trajectory_parser::Columns& columns =
+        Trajectory_parser::Default_columns);
+
+bool save(
+    const std::string& source_fname,
+    const Index& index,
+    const Trajectory_parser::Columns& columns =
+        Trajectory_parser::Default_columns);
+
+// Parses only the rows with the time in [t_begin, t_end]. The rows next to the
+// window are parsed as well, so the cost depends on the window size and the
+// stride, not on the file size
+bool load_window(
+    const std::string& source_fname,
+    const Index& index,
+    float t_begin,
+    float t_end,
+    Trajectory_data& out,
+    const Trajectory_parser::Columns& columns =
+        Trajectory_parser::Default_columns);
+
+} // namespace Trajectory_index
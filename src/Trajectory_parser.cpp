@@ -0,0 +1,843 @@
+#include "Trajectory_parser.h"
+// Local
+#include "Gzip_reader.h"
+#include "Mapped_file.h"
+#include "Thread_pool.h"
+// std
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+//******************************************************************************
+// is_delimiter
+//
+// Besides the real delimiters, the quotes and braces written by Wolfram
+// Mathematica are skipped as well
+//******************************************************************************
+
+inline bool is_delimiter(char c)
+{
+    return c == ' ' || c == '\t' || c == ',' || c == '\r' || c == '"' ||
+           c == '{' || c == '}';
+}
+
+//******************************************************************************
+// parse_number
+//******************************************************************************
+
+template<class T>
+inline bool parse_number(const char*& p, const char* end, T& out)
+{
+    if(p < end && *p == '+')
+        ++p;
+
+#if defined(__cpp_lib_to_chars)
+    auto res = std::from_chars(p, end, out);
+    if(res.ec != std::errc())
+        return false;
+    p = res.ptr;
+#else
+    // Fallback for standard libraries without floating-point from_chars: the
+    // token has to be copied to get a null-terminated string for strtof or
+    // strtod
+    char buff[64];
+    size_t len = 0;
+    while(p + len < end && len < sizeof(buff) - 1 && !is_delimiter(p[len]) &&
+          p[len] != '*' && p[len] != '\n')
+    {
+        buff[len] = p[len];
+        ++len;
+    }
+    buff[len] = '\0';
+
+    char* num_end = nullptr;
+    if constexpr(std::is_same_v<T, float>)
+        out = std::strtof(buff, &num_end);
+    else
+        out = std::strtod(buff, &num_end);
+    if(num_end == buff)
+        return false;
+    p += num_end - buff;
+#endif
+
+    // Wolfram Mathematica writes exponents as "*^", e.g., "1.5*^-7"
+    if(end - p > 2 && p[0] == '*' && p[1] == '^')
+    {
+        const char* exp_begin = p + 2;
+        if(*exp_begin == '+')
+            ++exp_begin;
+
+        int exponent = 0;
+        auto res = std::from_chars(exp_begin, end, exponent);
+        if(res.ec != std::errc())
+            return false;
+
+        out = static_cast<T>(out * std::pow(10., exponent));
+        p = res.ptr;
+    }
+
+    return true;
+}
+
+//******************************************************************************
+// Column_plan
+//
+// The loaded columns sorted by the position in a line, so a line is parsed in
+// one pass and stops at the last loaded column. The trajectory id of an
+// ensemble file is loaded as the extra output column Id_column
+//******************************************************************************
+
+const size_t Id_column = 5;
+
+struct Column_plan
+{
+    size_t count = 0;
+    std::array<size_t, 6> file_columns; // Ascending
+    std::array<size_t, 6> out_columns;  // Trajectory_data::column indices
+    size_t id_index = 0; // Position of the id in the plan, if it is loaded
+
+    explicit Column_plan(
+        const Trajectory_parser::Columns& columns,
+        size_t id_column = Trajectory_parser::No_column)
+    {
+        std::array<std::pair<size_t, size_t>, 6> pairs;
+        for(size_t i = 0; i < columns.size(); ++i)
+        {
+            if(columns[i] != Trajectory_parser::No_column)
+                pairs[count++] = {columns[i], i};
+        }
+        if(id_column != Trajectory_parser::No_column)
+            pairs[count++] = {id_column, Id_column};
+        std::sort(pairs.begin(), pairs.begin() + count);
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            file_columns[i] = pairs[i].first;
+            out_columns[i] = pairs[i].second;
+            if(out_columns[i] == Id_column)
+                id_index = i;
+        }
+    }
+
+    // The capacity grows geometrically, so appending the data in many small
+    // parts does not reallocate the columns every time
+    void reserve(Trajectory_data& out, size_t n) const
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            if(out_columns[i] == Id_column)
+                continue;
+
+            auto& column = out.column(out_columns[i]);
+            if(column.capacity() < n)
+                column.reserve(std::max(n, 2 * column.capacity()));
+        }
+    }
+};
+
+//******************************************************************************
+// parse_values
+//
+// Reads the values of the loaded columns of a line in the order of the plan.
+// If `id` is provided, it receives the trajectory id in double precision, so
+// the integer ids are exact up to 2^53. Returns false if the line does not
+// have a number in every loaded column
+//******************************************************************************
+
+inline bool parse_values(
+    const char* p,
+    const char* end,
+    const Column_plan& plan,
+    float* vals,
+    double* id = nullptr)
+{
+    size_t column = 0, next = 0;
+
+    while(next < plan.count)
+    {
+        while(p < end && is_delimiter(*p))
+            ++p;
+        if(p == end)
+            return false;
+
+        if(column == plan.file_columns[next])
+        {
+            if(id != nullptr && column == plan.file_columns[plan.id_index])
+            {
+                const char* number = p;
+                if(!parse_number(number, end, *id))
+                    return false;
+            }
+
+            // Lines with a text in a loaded column are ignored
+            if(!parse_number(p, end, vals[next]))
+                return false;
+
+            // A number has to be followed by a delimiter
+            if(p < end && !is_delimiter(*p))
+                return false;
+
+            // The same column can be loaded several times
+            while(next + 1 < plan.count &&
+                  plan.file_columns[next + 1] == column)
+            {
+                vals[next + 1] = vals[next];
+                ++next;
+            }
+            ++next;
+        }
+        else
+        {
+            while(p < end && !is_delimiter(*p))
+                ++p;
+        }
+        ++column;
+    }
+
+    return true;
+}
+
+//******************************************************************************
+// parse_line
+//******************************************************************************
+
+inline void parse_line(
+    const char* p,
+    const char* end,
+    const Column_plan& plan,
+    Trajectory_data& out)
+{
+    float vals[6];
+    if(!parse_values(p, end, plan, vals))
+        return;
+
+    for(size_t i = 0; i < plan.count; ++i)
+        out.column(plan.out_columns[i]).push_back(vals[i]);
+}
+
+//******************************************************************************
+// parse_lines
+//******************************************************************************
+
+size_t parse_lines(
+    const char* begin,
+    const char* end,
+    const Column_plan& plan,
+    Trajectory_data& out,
+    std::vector<Trajectory_parser::Row_offset>* row_offsets = nullptr,
+    size_t offset_stride = 0,
+    const char* base = nullptr)
+{
+    const size_t initial_size = out.size();
+
+    // Estimate the number of points from the length of the first line to avoid
+    // reallocations of the columns
+    {
+        auto first_eol = static_cast<const char*>(
+            std::memchr(begin, '\n', end - begin));
+        if(first_eol != nullptr && first_eol > begin)
+        {
+            plan.reserve(
+                out,
+                initial_size + (end - begin) / (first_eol - begin + 1));
+        }
+    }
+
+    const char* line = begin;
+    while(line < end)
+    {
+        // memchr is vectorized by the standard library implementations
+        auto eol =
+            static_cast<const char*>(std::memchr(line, '\n', end - line));
+        if(eol == nullptr)
+            eol = end;
+
+        const size_t row = out.size();
+        parse_line(line, eol, plan, out);
+
+        // Rows are counted from the beginning of the range
+        if(row_offsets != nullptr && out.size() != row &&
+           (row - initial_size) % offset_stride == 0)
+        {
+            row_offsets->push_back({static_cast<uint64_t>(line - base),
+                                    static_cast<uint64_t>(row - initial_size)});
+        }
+        line = eol + 1;
+    }
+
+    return out.size() - initial_size;
+}
+
+//******************************************************************************
+// parse_ensemble_lines
+//
+// Parses the lines and appends every row to the member with its id. `index`
+// maps the ids to the members of `out`
+//******************************************************************************
+
+void parse_ensemble_lines(
+    const char* begin,
+    const char* end,
+    const Column_plan& plan,
+    Trajectory_parser::Ensemble& out,
+    std::unordered_map<double, size_t>& index)
+{
+    // The rows of a trajectory usually follow each other, so the member of the
+    // previous row is checked before the lookup
+    size_t member = SIZE_MAX;
+    double member_id = 0.;
+
+    float vals[6];
+    double id;
+    const char* line = begin;
+    while(line < end)
+    {
+        auto eol =
+            static_cast<const char*>(std::memchr(line, '\n', end - line));
+        if(eol == nullptr)
+            eol = end;
+
+        // A row without a valid id belongs to no trajectory
+        if(parse_values(line, eol, plan, vals, &id) && !std::isnan(id))
+        {
+            if(member == SIZE_MAX || id != member_id)
+            {
+                auto it = index.find(id);
+                if(it == index.end())
+                {
+                    it = index.emplace(id, out.members.size()).first;
+                    out.ids.push_back(id);
+                    out.members.emplace_back();
+                }
+                member = it->second;
+                member_id = id;
+            }
+
+            auto& data = out.members[member];
+            for(size_t i = 0; i < plan.count; ++i)
+            {
+                if(i != plan.id_index)
+                    data.column(plan.out_columns[i]).push_back(vals[i]);
+            }
+        }
+
+        line = eol + 1;
+    }
+}
+
+//******************************************************************************
+// split_lines
+//
+// Splits the text into ranges of roughly the same size. Every range except the
+// first one starts right after a line end, so no line is split
+//******************************************************************************
+
+std::vector<const char*> split_lines(
+    const char* begin,
+    const char* end,
+    size_t num_chunks)
+{
+    const size_t length = end - begin;
+    std::vector<const char*> bounds(num_chunks + 1);
+    bounds.front() = begin;
+    bounds.back() = end;
+    for(size_t i = 1; i < num_chunks; ++i)
+    {
+        const char* p = std::max(begin + i * (length / num_chunks),
+                                 bounds[i - 1]);
+        auto eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        bounds[i] = eol == nullptr ? end : eol + 1;
+    }
+
+    return bounds;
+}
+
+//******************************************************************************
+// parse_gzip
+//
+// The decompressed blocks are parsed as they arrive. A line split between two
+// blocks is collected separately, so the blocks are not copied
+//******************************************************************************
+
+bool parse_gzip(
+    const std::string& fname,
+    Trajectory_data& out,
+    Trajectory_parser::Progress* progress,
+    const Trajectory_parser::Columns& columns)
+{
+    Gzip_reader reader(fname);
+    if(!reader.is_open())
+        return false;
+
+    std::string split_line;
+    size_t reported_bytes = 0;
+    auto report_progress = [&]() {
+        if(progress == nullptr)
+            return;
+        const size_t bytes = reader.compressed_bytes();
+        progress->bytes += bytes - reported_bytes;
+        reported_bytes = bytes;
+    };
+
+    const char* block;
+    size_t size;
+    while(reader.next_block(block, size))
+    {
+        if(progress != nullptr && progress->is_canceled)
+            return false;
+
+        const char* end = block + size;
+        auto first_eol =
+            static_cast<const char*>(std::memchr(block, '\n', size));
+        if(first_eol == nullptr)
+        {
+            split_line.append(block, end);
+            continue;
+        }
+
+        split_line.append(block, first_eol + 1);
+        Trajectory_parser::parse(
+            split_line.data(),
+            split_line.data() + split_line.size(),
+            out,
+            columns);
+
+        const char* last_eol = end;
+        while(last_eol[-1] != '\n')
+            --last_eol;
+
+        Trajectory_parser::parse_parallel(
+            first_eol + 1,
+            last_eol,
+            out,
+            nullptr,
+            columns);
+        split_line.assign(last_eol, end);
+
+        report_progress();
+    }
+
+    Trajectory_parser::parse(
+        split_line.data(),
+        split_line.data() + split_line.size(),
+        out,
+        columns);
+    report_progress();
+
+    return !reader.has_error() &&
+           (progress == nullptr || !progress->is_canceled);
+}
+} // namespace
+
+//******************************************************************************
+// is_complete
+//******************************************************************************
+
+bool Trajectory_parser::is_complete(const Columns& columns)
+{
+    return std::find(columns.begin(), columns.end(), No_column) ==
+           columns.end();
+}
+
+//******************************************************************************
+// parse
+//******************************************************************************
+
+size_t Trajectory_parser::parse(
+    const char* begin,
+    const char* end,
+    Trajectory_data& out,
+    const Columns& columns/* = Default_columns*/)
+{
+    return parse_lines(begin, end, Column_plan(columns), out);
+}
+
+//******************************************************************************
+// parse_parallel
+//******************************************************************************
+
+size_t Trajectory_parser::parse_parallel(
+    const char* begin,
+    const char* end,
+    Trajectory_data& out,
+    Progress* progress/* = nullptr*/,
+    const Columns& columns/* = Default_columns*/,
+    std::vector<Row_offset>* row_offsets/* = nullptr*/,
+    size_t offset_stride/* = 0*/)
+{
+    if(offset_stride == 0)
+        row_offsets = nullptr;
+
+    // Chunks smaller than this are not worth the scheduling overhead
+    const size_t min_chunk_size = 1 << 20;
+
+    auto& pool = Thread_pool::global();
+    const size_t length = end - begin;
+    const size_t num_chunks =
+        std::min(length / min_chunk_size, 4 * (pool.size() + 1));
+    if(num_chunks < 2)
+    {
+        if(progress != nullptr && progress->is_canceled)
+            return 0;
+
+        const size_t num_points = parse_lines(
+            begin,
+            end,
+            Column_plan(columns),
+            out,
+            row_offsets,
+            offset_stride,
+            begin);
+        if(progress != nullptr)
+            progress->bytes += length;
+        return num_points;
+    }
+
+    const auto bounds = split_lines(begin, end, num_chunks);
+
+    const Column_plan plan(columns);
+    std::vector<Trajectory_data> chunks(num_chunks);
+    std::vector<std::vector<Row_offset>> chunk_offsets(num_chunks);
+    pool.parallel_for(num_chunks, [&](size_t i) {
+        if(progress != nullptr && progress->is_canceled)
+            return;
+
+        parse_lines(
+            bounds[i],
+            bounds[i + 1],
+            plan,
+            chunks[i],
+            row_offsets != nullptr ? &chunk_offsets[i] : nullptr,
+            offset_stride,
+            begin);
+
+        if(progress == nullptr)
+            return;
+        progress->bytes += bounds[i + 1] - bounds[i];
+    });
+
+    if(progress != nullptr && progress->is_canceled)
+        return 0;
+
+    // Stitch the chunks in the file order, so the time stamps keep the order
+    // they have in the file
+    std::vector<size_t> offsets(num_chunks + 1, out.size());
+    for(size_t i = 0; i < num_chunks; ++i)
+        offsets[i + 1] = offsets[i] + chunks[i].size();
+
+    // The rows of the chunks are counted from the beginning of the range
+    if(row_offsets != nullptr)
+    {
+        for(size_t i = 0; i < num_chunks; ++i)
+        {
+            for(auto ro : chunk_offsets[i])
+            {
+                ro.row += offsets[i] - offsets.front();
+                row_offsets->push_back(ro);
+            }
+        }
+    }
+
+    const size_t total = offsets.back();
+    for(size_t j = 0; j < plan.count; ++j)
+        out.column(plan.out_columns[j]).resize(total);
+
+    pool.parallel_for(num_chunks, [&](size_t i) {
+        for(size_t j = 0; j < plan.count; ++j)
+        {
+            const auto& src = chunks[i].column(plan.out_columns[j]);
+            auto& dst = out.column(plan.out_columns[j]);
+            std::copy(src.begin(), src.end(), dst.begin() + offsets[i]);
+        }
+
+        // Release the memory of the chunk as soon as possible
+        chunks[i] = Trajectory_data();
+    });
+
+    return total - offsets.front();
+}
+
+//******************************************************************************
+// parse_ensemble
+//******************************************************************************
+
+size_t Trajectory_parser::parse_ensemble(
+    const char* begin,
+    const char* end,
+    size_t id_column,
+    Ensemble& out,
+    Progress* progress/* = nullptr*/,
+    const Columns& columns/* = Default_columns*/)
+{
+    const Column_plan plan(columns, id_column);
+
+    auto count_rows = [&out]() {
+        size_t num_rows = 0;
+        for(const auto& m : out.members)
+            num_rows += m.size();
+        return num_rows;
+    };
+    const size_t initial_rows = count_rows();
+
+    std::unordered_map<double, size_t> index;
+    for(size_t i = 0; i < out.ids.size(); ++i)
+        index.emplace(out.ids[i], i);
+
+    const size_t min_chunk_size = 1 << 20;
+
+    auto& pool = Thread_pool::global();
+    const size_t length = end - begin;
+    const size_t num_chunks =
+        std::min(length / min_chunk_size, 4 * (pool.size() + 1));
+    if(num_chunks < 2)
+    {
+        if(progress != nullptr && progress->is_canceled)
+            return 0;
+
+        parse_ensemble_lines(begin, end, plan, out, index);
+        if(progress != nullptr)
+            progress->bytes += length;
+        return count_rows() - initial_rows;
+    }
+
+    // Every chunk sorts its rows into its own members
+    const auto bounds = split_lines(begin, end, num_chunks);
+    std::vector<Ensemble> chunks(num_chunks);
+    pool.parallel_for(num_chunks, [&](size_t i) {
+        if(progress != nullptr && progress->is_canceled)
+            return;
+
+        std::unordered_map<double, size_t> chunk_index;
+        parse_ensemble_lines(
+            bounds[i],
+            bounds[i + 1],
+            plan,
+            chunks[i],
+            chunk_index);
+
+        if(progress != nullptr)
+            progress->bytes += bounds[i + 1] - bounds[i];
+    });
+
+    if(progress != nullptr && progress->is_canceled)
+        return 0;
+
+    // The members of the chunks are matched by the id. The members are ordered
+    // by their first rows in the text, the same as the sequential parsing does
+    struct Part
+    {
+        size_t chunk;
+        size_t member;
+    };
+    std::vector<std::vector<Part>> parts(out.members.size());
+    for(size_t c = 0; c < num_chunks; ++c)
+    {
+        for(size_t m = 0; m < chunks[c].ids.size(); ++m)
+        {
+            const double id = chunks[c].ids[m];
+            auto it = index.find(id);
+            if(it == index.end())
+            {
+                it = index.emplace(id, out.members.size()).first;
+                out.ids.push_back(id);
+                out.members.emplace_back();
+                parts.emplace_back();
+            }
+            parts[it->second].push_back({c, m});
+        }
+    }
+
+    // Every member is concatenated from its parts in the text order
+    pool.parallel_for(out.members.size(), [&](size_t m) {
+        if(parts[m].empty())
+            return;
+
+        auto& dst = out.members[m];
+        size_t num_rows = dst.size();
+        for(const auto& part : parts[m])
+            num_rows += chunks[part.chunk].members[part.member].size();
+        plan.reserve(dst, num_rows);
+
+        for(const auto& part : parts[m])
+        {
+            auto& src = chunks[part.chunk].members[part.member];
+            for(size_t i = 0; i < plan.count; ++i)
+            {
+                if(i == plan.id_index)
+                    continue;
+                const auto& s = src.column(plan.out_columns[i]);
+                auto& d = dst.column(plan.out_columns[i]);
+                d.insert(d.end(), s.begin(), s.end());
+            }
+
+            // Release the memory of the part as soon as possible
+            src = Trajectory_data();
+        }
+    });
+
+    return count_rows() - initial_rows;
+}
+
+//******************************************************************************
+// parse_ensemble_file
+//******************************************************************************
+
+bool Trajectory_parser::parse_ensemble_file(
+    const std::string& fname,
+    size_t id_column,
+    Ensemble& out,
+    Progress* progress/* = nullptr*/,
+    const Columns& columns/* = Default_columns*/)
+{
+    // The compressed text cannot be split into chunks
+    if(Gzip_reader::is_gzip(fname))
+        return false;
+
+    Mapped_file file(fname);
+    if(!file.is_open())
+        return false;
+
+    parse_ensemble(
+        file.data(),
+        file.data() + file.size(),
+        id_column,
+        out,
+        progress,
+        columns);
+    return progress == nullptr || !progress->is_canceled;
+}
+
+//******************************************************************************
+// parse_sample
+//******************************************************************************
+
+size_t Trajectory_parser::parse_sample(
+    const char* begin,
+    const char* end,
+    size_t num_lines,
+    Trajectory_data& out,
+    const Columns& columns/* = Default_columns*/)
+{
+    const size_t initial_size = out.size();
+    const size_t length = end - begin;
+    if(length == 0 || num_lines == 0)
+        return 0;
+
+    const Column_plan plan(columns);
+    plan.reserve(out, initial_size + num_lines);
+
+    // The samples are taken at the same byte distance, which is close to the
+    // same number of lines as the lines of a file have similar lengths
+    const char* prev_line = nullptr;
+    for(size_t i = 0; i < num_lines; ++i)
+    {
+        const char* line = begin + i * (length / num_lines);
+        if(i > 0)
+        {
+            auto eol = static_cast<const char*>(
+                std::memchr(line, '\n', end - line));
+            if(eol == nullptr)
+                break;
+            line = eol + 1;
+        }
+
+        // Short files have several samples in the same line
+        if(prev_line != nullptr && line <= prev_line)
+            continue;
+        prev_line = line;
+
+        auto eol =
+            static_cast<const char*>(std::memchr(line, '\n', end - line));
+        if(eol == nullptr)
+            eol = end;
+        parse_line(line, eol, plan, out);
+    }
+
+    return out.size() - initial_size;
+}
+
+//******************************************************************************
+// parse_file_sample
+//******************************************************************************
+
+bool Trajectory_parser::parse_file_sample(
+    const std::string& fname,
+    size_t num_lines,
+    Trajectory_data& out,
+    const Columns& columns/* = Default_columns*/)
+{
+    // Compressed files cannot be sampled without decompressing them
+    if(Gzip_reader::is_gzip(fname))
+        return false;
+
+    Mapped_file file(fname);
+    if(!file.is_open())
+        return false;
+
+    parse_sample(
+        file.data(),
+        file.data() + file.size(),
+        num_lines,
+        out,
+        columns);
+    return true;
+}
+
+//******************************************************************************
+// parse_file
+//******************************************************************************
+
+bool Trajectory_parser::parse_file(
+    const std::string& fname,
+    Trajectory_data& out,
+    size_t* parsed_size/* = nullptr*/,
+    Progress* progress/* = nullptr*/,
+    const Columns& columns/* = Default_columns*/,
+    std::vector<Row_offset>* row_offsets/* = nullptr*/,
+    size_t offset_stride/* = 0*/)
+{
+    if(Gzip_reader::is_gzip(fname))
+    {
+        if(parsed_size != nullptr)
+        {
+            std::error_code ec;
+            const auto size = std::filesystem::file_size(fname, ec);
+            *parsed_size = ec ? 0 : static_cast<size_t>(size);
+        }
+        return parse_gzip(fname, out, progress, columns);
+    }
+
+    Mapped_file file(fname);
+    if(!file.is_open())
+        return false;
+
+    // The last line might be not completely written yet, it is left for the
+    // next read
+    const char* end = file.data() + file.size();
+    if(parsed_size != nullptr)
+    {
+        while(end != file.data() && *(end - 1) != '\n')
+            --end;
+        *parsed_size = end - file.data();
+    }
+
+    parse_parallel(
+        file.data(),
+        end,
+        out,
+        progress,
+        columns,
+        row_offsets,
+        offset_stride);
+    return progress == nullptr || !progress->is_canceled;
+}
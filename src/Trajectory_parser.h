@@ -0,0 +1,133 @@
+#pragma once
+// Local
+#include "Trajectory_data.h"
+// std
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Parser of text trajectory files. Every line of a file describes one point of
+// a trajectory: the time stamp and the state variables. The numbers can be
+// separated by tabs, spaces or commas. Lines exported from Wolfram Mathematica,
+// e.g. "{0.1, 2.5*^-3, ...}", are supported as well. Lines that do not contain
+// a number in every loaded column are skipped.
+namespace Trajectory_parser
+{
+// Columns of the file (numbered from zero) that are loaded as the time and x,
+// y, z, w. Other columns are skipped without being converted, so the parsing
+// cost depends on the loaded columns, not on the number of the columns. An
+// output column set to No_column is left empty. Such a partial parse only adds
+// columns to the ones parsed before, a trajectory needs all of them, see
+// is_complete()
+using Columns = std::array<size_t, 5>;
+constexpr size_t No_column = SIZE_MAX;
+constexpr Columns Default_columns = {0, 1, 2, 3, 4};
+
+// True if none of the columns is No_column
+bool is_complete(const Columns& columns);
+
+// Position of a parsed row in the text
+struct Row_offset
+{
+    uint64_t offset; // Byte offset of the line
+    uint64_t row;
+};
+
+// Trajectories of an ensemble file, e.g. a parameter sweep, ordered by their
+// first rows in the file. The ids are read in double precision, the rows with
+// a NaN id are skipped
+struct Ensemble
+{
+    std::vector<double> ids;
+    std::vector<Trajectory_data> members;
+};
+
+// Shared between the parsing and the thread that observes it
+struct Progress
+{
+    std::atomic<size_t> bytes{0};        // Number of the processed bytes
+    std::atomic<bool> is_canceled{false}; // Set to stop the parsing
+};
+
+// Parses the characters in the range [begin, end) and appends the points to
+// `out`. Returns the number of the appended points
+size_t parse(
+    const char* begin,
+    const char* end,
+    Trajectory_data& out,
+    const Columns& columns = Default_columns);
+
+// Does the same as parse(), but splits large inputs into chunks aligned to the
+// line ends and parses the chunks on the global thread pool. The chunks are
+// stitched in order, so the result is identical to the sequential parsing.
+// If the parsing is canceled via `progress`, `out` is left unchanged. If
+// `row_offsets` is provided, it receives the positions of some of the parsed
+// rows, not more than `offset_stride` rows apart, counted from `begin`
+size_t parse_parallel(
+    const char* begin,
+    const char* end,
+    Trajectory_data& out,
+    Progress* progress = nullptr,
+    const Columns& columns = Default_columns,
+    std::vector<Row_offset>* row_offsets = nullptr,
+    size_t offset_stride = 0);
+
+// Parses the text of an ensemble: every line has the id of its trajectory in
+// `id_column`, the lines of a trajectory do not have to be adjacent. The text
+// is parsed in chunks on the global thread pool and every chunk sorts its rows
+// into the members, so the text is read only once. The rows of a member keep
+// their order in the text. Returns the number of the appended points
+size_t parse_ensemble(
+    const char* begin,
+    const char* end,
+    size_t id_column,
+    Ensemble& out,
+    Progress* progress = nullptr,
+    const Columns& columns = Default_columns);
+
+// Memory-maps the file and parses it with parse_ensemble(). Returns false for
+// gzip-compressed files or if the parsing is canceled
+bool parse_ensemble_file(
+    const std::string& fname,
+    size_t id_column,
+    Ensemble& out,
+    Progress* progress = nullptr,
+    const Columns& columns = Default_columns);
+
+// Parses at most `num_lines` lines evenly spread over the range [begin, end),
+// the first line is always included. The time does not depend on the size of
+// the range, so it is suitable for a quick preview of a huge file
+size_t parse_sample(
+    const char* begin,
+    const char* end,
+    size_t num_lines,
+    Trajectory_data& out,
+    const Columns& columns = Default_columns);
+
+// Memory-maps the file and samples it with parse_sample(). Returns false for
+// gzip-compressed files
+bool parse_file_sample(
+    const std::string& fname,
+    size_t num_lines,
+    Trajectory_data& out,
+    const Columns& columns = Default_columns);
+
+// Memory-maps the file and parses it. Gzip-compressed files are decompressed
+// while they are parsed without keeping the whole decompressed text. Returns
+// false if the file cannot be read or the parsing is canceled. If
+// `parsed_size` is provided, only the complete lines are parsed and it
+// receives their size, so a line that is still being written is read later.
+// The row offsets are collected as in parse_parallel(), except for the
+// compressed files
+bool parse_file(
+    const std::string& fname,
+    Trajectory_data& out,
+    size_t* parsed_size = nullptr,
+    Progress* progress = nullptr,
+    const Columns& columns = Default_columns,
+    std::vector<Row_offset>* row_offsets = nullptr,
+    size_t offset_stride = 0);
+
+} // namespace Trajectory_parser
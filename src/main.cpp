@@ -20,9 +20,6 @@
 #include <stdio.h>
 #include <math.h>
 #include <memory.h>
-#ifdef __EMSCRIPTEN__
-#include <fstream>
-#endif
 // glm
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -31,6 +28,7 @@
 #include <glm/gtx/euler_angles.hpp>
 #include <glm/gtx/quaternion.hpp>
 // Local
+#include "Alloc_counter.h"
 #include "Mesh_generator.h"
 #include "Geometry_engine.h"
 #include "Scene.h"
@@ -115,6 +113,16 @@ auto Player_speed(0.1f);
 
 auto Curve_max_deviation(0.8f);
 
+// Follow mode: the loaded files are polled for the appended data
+auto Follow_files(false);
+std::chrono::time_point<std::chrono::system_clock> Last_follow_timepoint;
+
+#ifdef COUNT_ALLOCATIONS
+// Heap allocations made by the previous frame
+size_t Frame_allocations(0);
+size_t Frame_start_alloc_count(0);
+#endif // COUNT_ALLOCATIONS
+
 //******************************************************************************
 // Color_to_ImVec4
 //******************************************************************************
@@ -272,8 +280,20 @@ void update_timer()
 
 void mainloop()
 {
+#ifdef COUNT_ALLOCATIONS
+    const size_t alloc_count = Alloc_counter::get_count();
+    Frame_allocations = alloc_count - Frame_start_alloc_count;
+    Frame_start_alloc_count = alloc_count;
+#endif // COUNT_ALLOCATIONS
+
     update_timer();
 
+    // The loaded and simplified curves and the previewed statistics replace
+    // the current ones between frames
+    Scene_objs.finish_loading();
+    Scene_objs.finish_simplification();
+    Scene_objs.finish_stats_preview();
+
     ImGuiIO& io = ImGui::GetIO(); (void)io;
 
     SDL_Event event;
@@ -346,6 +366,9 @@ void mainloop()
             ImGuiWindowFlags_NoResize);
 
         ImGui::Text("%.1f FPS", io.Framerate);
+#ifdef COUNT_ALLOCATIONS
+        ImGui::Text("%zu allocations per frame", Frame_allocations);
+#endif // COUNT_ALLOCATIONS
 #ifdef DEBUG
         ImGui::Text((char*)glGetString(GL_VERSION));
         ImGui::Text("OpenGL error: %d", glGetError());
@@ -371,7 +394,9 @@ void mainloop()
             ZeroMemory( &ofn, sizeof( ofn ) );
             ofn.lStructSize  = sizeof(ofn);
             ofn.hwndOwner    = wm_info.info.win.window;
-            ofn.lpstrFilter  = "Text Files\0*.txt\0Any File\0*.*\0";
+            ofn.lpstrFilter  = "Text Files\0*.txt;*.gz\0"
+                               "Binary Files\0*.npy;*.f32;*.f64\0"
+                               "Any File\0*.*\0";
             ofn.lpstrFile    = fn;
             ofn.nMaxFile     = MAX_PATH;
             ofn.lpstrTitle   = "Select an ODE";
@@ -413,7 +438,7 @@ void mainloop()
 #endif
             if(!fnames.empty())
             {
-                Scene_objs.load_ode(
+                Scene_objs.load_ode_async(
                     fnames,
                     Curve_max_deviation);
             }
@@ -421,6 +446,27 @@ void mainloop()
         }
         ImGui::SameLine();
         ImGui::Checkbox("Scale tesseract", &State->scale_tesseract);
+        ImGui::Checkbox("Follow files", &Follow_files);
+
+        if(Scene_objs.is_loading())
+        {
+            if(Scene_objs.is_loading_canceled())
+            {
+                ImGui::ProgressBar(
+                    Scene_objs.loading_progress(),
+                    ImVec2(-1.f, 0.f),
+                    "Canceling...");
+            }
+            else
+            {
+                ImGui::ProgressBar(
+                    Scene_objs.loading_progress(),
+                    ImVec2(-70.f, 0.f));
+                ImGui::SameLine();
+                if(ImGui::Button("Cancel"))
+                    Scene_objs.cancel_loading();
+            }
+        }
 
         if (ImGui::CollapsingHeader("Player"))
         {
@@ -450,7 +496,123 @@ void mainloop()
 
         if (ImGui::CollapsingHeader("Curve simplification"))
         {
-            ImGui::SliderFloat("Max. deviation", &Curve_max_deviation, 0.f, 3.f);
+            // The loaded curves are simplified again in the background
+            if(ImGui::SliderFloat(
+                   "Max. deviation", &Curve_max_deviation, 0.f, 3.f))
+            {
+                Scene_objs.simplify_curves(Curve_max_deviation);
+            }
+            if(Scene_objs.is_simplifying())
+                ImGui::Text("Simplifying...");
+            // Applied when the trajectories are loaded
+            ImGui::InputFloat(
+                "Stationary eps.",
+                &State->stationary_epsilon,
+                0.f,
+                0.f,
+                "%.1e");
+            State->stationary_epsilon =
+                std::max(State->stationary_epsilon, 0.f);
+            ImGui::Checkbox("16-bit curves", &State->quantize_curves);
+
+            size_t curves_memory = 0;
+            for(const auto& c : State->curves)
+                curves_memory += c->memory_size();
+            ImGui::Text("Curves: %.1f MB", curves_memory / 1048576.f);
+        }
+
+        if (ImGui::CollapsingHeader("Columns"))
+        {
+            // Columns of the files are numbered from zero. A negative id column
+            // loads every file as a single trajectory
+            static int time_column = 0;
+            static int state_columns[4] = { 1, 2, 3, 4 };
+            static int id_column = -1;
+            ImGui::InputInt("Time", &time_column);
+            ImGui::InputInt4("x, y, z, w", state_columns);
+            ImGui::InputInt("Trajectory id", &id_column);
+            if(ImGui::Button("Apply"))
+            {
+                Trajectory_parser::Columns columns;
+                columns[0] = static_cast<size_t>(std::max(time_column, 0));
+                for(size_t i = 0; i < 4; ++i)
+                {
+                    columns[i + 1] =
+                        static_cast<size_t>(std::max(state_columns[i], 0));
+                }
+                Scene_objs.set_columns(columns);
+                Scene_objs.set_id_column(id_column < 0 ?
+                    Trajectory_parser::No_column :
+                    static_cast<size_t>(id_column));
+                Scene_objs.reload_ode_async(Curve_max_deviation);
+            }
+        }
+
+#ifndef __EMSCRIPTEN__
+        if (ImGui::CollapsingHeader("Live stream"))
+        {
+            // A running solver connects to the address and sends its points,
+            // the curve keeps only the latest ones
+            static char address[256] = {};
+            if(address[0] == '\0')
+            {
+                const auto default_address =
+                    Stream_receiver::default_address();
+                default_address.copy(address, sizeof(address) - 1);
+            }
+            static int max_points = 100000;
+            static float max_duration = 0.f;
+
+            ImGui::InputText("Address", address, sizeof(address));
+            ImGui::InputInt("Max. points", &max_points);
+            ImGui::InputFloat("Max. duration", &max_duration);
+
+            if(Scene_objs.is_streaming())
+            {
+                ImGui::Text(Scene_objs.is_stream_connected() ?
+                                "Receiving" :
+                                "Waiting for the solver...");
+                if(ImGui::Button("Stop"))
+                    Scene_objs.stop_stream();
+            }
+            else if(ImGui::Button("Start"))
+            {
+                if(!Scene_objs.start_stream(
+                       address,
+                       static_cast<size_t>(std::max(max_points, 2)),
+                       max_duration))
+                {
+                    ImGui::OpenPopup("Stream error");
+                }
+            }
+
+            if(ImGui::BeginPopup("Stream error"))
+            {
+                ImGui::Text(
+                    "The address cannot be listened to, or a file that is not "
+                    "a socket is there");
+                ImGui::EndPopup();
+            }
+        }
+#endif
+
+        if (ImGui::CollapsingHeader("Time window"))
+        {
+            // Only the points of the window are loaded, the timeline shows the
+            // overview of the whole trajectory
+            static float window[2] = { 0.f, 100.f };
+            ImGui::InputFloat2("From, to", window);
+            if(ImGui::Button("Load window"))
+            {
+                Scene_objs.set_time_window(window[0], window[1]);
+                Scene_objs.reload_ode_async(Curve_max_deviation);
+            }
+            ImGui::SameLine();
+            if(ImGui::Button("Full range") && Scene_objs.has_time_window())
+            {
+                Scene_objs.clear_time_window();
+                Scene_objs.reload_ode_async(Curve_max_deviation);
+            }
         }
 
         // We cannot use std::vector<bool> becase it is impossible to get
@@ -602,22 +764,18 @@ void mainloop()
 
         if (ImGui::CollapsingHeader("Switch detection"))
         {
-            ImGui::SliderFloat(
+            // The curves are updated in the background while the thresholds
+            // are dragged
+            bool is_changed = ImGui::SliderFloat(
                 "Kernel size", &State->stat_kernel_size, 0.f, 0.1f);
-            ImGui::SliderFloat(
+            is_changed |= ImGui::SliderFloat(
                 "Max movement", &State->stat_max_movement, 0.f, 0.05f);
-            ImGui::SliderFloat(
+            is_changed |= ImGui::SliderFloat(
                 "Value threshold", &State->stat_max_value, 0.f, 0.1f);
-            if(ImGui::Button("Update"))
-            {
-                for(auto& c: State->curves)
-                {
-                    c->update_stats(
-                        State->stat_kernel_size,
-                        State->stat_max_movement,
-                        State->stat_max_value);
-                }
-            }
+            if(is_changed)
+                Scene_objs.preview_stats();
+            if(Scene_objs.is_previewing_stats())
+                ImGui::Text("Updating...");
         }
 
         State->rotation_3D = glm::eulerAngleXYZ(euler[0],
@@ -742,8 +900,11 @@ void mainloop()
                        1,
                        GL_FALSE,
                        glm::value_ptr(proj_ortho));
-    Screen_shader::Screen_geometry separator;
-    Screen_shader::Line_strip line;
+    // Both keep their memory from frame to frame
+    static Screen_shader::Screen_geometry separator;
+    static Screen_shader::Line_strip line;
+    separator.clear();
+    line.clear();
     line.emplace_back(Screen_shader::Line_point(
         glm::vec2(Left_panel_size, timeline_height),
         4.f,
@@ -757,6 +918,20 @@ void mainloop()
     separator.init_buffers();
     Screen_shad->draw_geometry(separator);
 
+    // Add the points received from a solver since the previous frame
+    Scene_objs.update_stream();
+
+    // Read the data appended to the loaded files
+    if(Follow_files)
+    {
+        const auto now = std::chrono::system_clock::now();
+        if(now - Last_follow_timepoint > std::chrono::milliseconds(250))
+        {
+            Last_follow_timepoint = now;
+            Scene_objs.update_followed_files();
+        }
+    }
+
     // Draw other objects
     Text_ren->clear();
 
@@ -771,10 +946,29 @@ void mainloop()
 }
 
 #if __EMSCRIPTEN__
-#include <cstdio>
+#include <cstdlib>
+
+// The files received from JavaScript, they are loaded by js_load_ode()
+std::vector<Trajectory_buffer> Js_buffers;
 
 extern "C"
 {
+//******************************************************************************
+// js_add_ode
+//
+// This function is called from JavaScript to pass the content of a file. The
+// memory is allocated with _malloc, the buffer takes the ownership of it
+//******************************************************************************
+void js_add_ode(char* data, size_t size, const char* name)
+{
+    Js_buffers.emplace_back(
+        std::shared_ptr<const char>(
+            data,
+            [](const char* p) { std::free(const_cast<char*>(p)); }),
+        size,
+        name);
+}
+
 //******************************************************************************
 // js_load_ode
 //
@@ -782,23 +976,8 @@ extern "C"
 //******************************************************************************
 void js_load_ode()
 {
-    std::vector<std::string> fnames;
-    
-    for(size_t i = 0; i < 100; ++i)
-    {
-        std::string fn("user_ode" + std::to_string(i) + ".txt");
-        std::ifstream f(fn);
-        if(f.good())
-            fnames.push_back(fn);
-        else
-            break;
-    }
-
-    Scene_objs.load_ode(fnames, Curve_max_deviation);
-
-    // The file has to removed to be able to load a new file with the same name
-    for(auto& fn: fnames)
-        remove(fn.c_str());
+    Scene_objs.load_ode(Js_buffers, Curve_max_deviation);
+    Js_buffers.clear();
 }
 }
 #endif
@@ -0,0 +1,86 @@
+// Local
+#include "src/Binary_trajectory.h"
+#include "src/Trajectory_parser.h"
+// std
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+int num_failures = 0;
+
+//******************************************************************************
+// check
+//******************************************************************************
+
+void check(bool condition, const char* description)
+{
+    if(condition)
+        return;
+
+    std::printf("FAILED: %s\n", description);
+    ++num_failures;
+}
+} // namespace
+
+//******************************************************************************
+// main
+//
+// A trajectory needs all the five columns, a column set to No_column is
+// rejected where a trajectory is loaded and left empty by a partial parse
+//******************************************************************************
+
+int main()
+{
+    using Trajectory_parser::No_column;
+
+    Trajectory_parser::Columns columns = Trajectory_parser::Default_columns;
+    check(Trajectory_parser::is_complete(columns), "default columns");
+    for(size_t i = 0; i < columns.size(); ++i)
+    {
+        auto partial = columns;
+        partial[i] = No_column;
+        check(!Trajectory_parser::is_complete(partial), "incomplete columns");
+    }
+
+    // Binary files are loaded as trajectories
+    const std::vector<float> values = {0.f, 1.f, 2.f, 3.f, 4.f,
+                                       1.f, 5.f, 6.f, 7.f, 8.f};
+    std::vector<char> bytes(values.size() * sizeof(float));
+    std::memcpy(bytes.data(), values.data(), bytes.size());
+
+    Trajectory_data binary;
+    check(Binary_trajectory::load(
+              "test.f32", bytes.data(), bytes.size(), binary),
+          "binary file");
+    check(binary.size() == 2 && binary.coords[3][1] == 8.f, "binary values");
+
+    Trajectory_data partial_binary;
+    check(!Binary_trajectory::load(
+              "test.f32",
+              bytes.data(),
+              bytes.size(),
+              partial_binary,
+              {0, 1, 2, No_column, 4}),
+          "binary file without the z column");
+
+    // The text parser leaves the column empty, Scene parses the missing
+    // columns of a loaded file this way
+    const char text[] = "0 1 2 3 4\n1 5 6 7 8\n";
+    Trajectory_data parsed;
+    Trajectory_parser::parse(
+        text,
+        text + std::strlen(text),
+        parsed,
+        {3, No_column, No_column, No_column, No_column});
+    check(parsed.size() == 2 && parsed.time[1] == 7.f, "partial parse");
+    for(const auto& c : parsed.coords)
+        check(c.empty(), "skipped column is empty");
+
+    if(num_failures != 0)
+        return 1;
+
+    std::printf("OK\n");
+    return 0;
+}